@@ -0,0 +1,537 @@
+/*
+* @author   Jatin Jain
+* @file     aio.c
+* @desc     asynchronous file I/O. A queue submits reads and writes through io_uring (set up with the raw syscalls, no liburing)
+*           and falls back to a worker thread doing pread/pwrite when io_uring is not available. Setting QUICKSORT_AIO=threads
+*           in the environment forces the fallback.
+* @date     17 october 2026
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "aio.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define HAVE_IO_URING 1
+#endif
+#endif
+#endif
+
+#define AIO_IDLE    0
+#define AIO_PENDING 1
+#define AIO_DONE    2
+
+#define AIO_MAX_SQE_LEN 0x7ffff000u     // largest transfer the kernel does in one read or write
+
+struct AioQueue {
+    int uring;
+    unsigned depth;
+    unsigned inflight;
+#ifdef HAVE_IO_URING
+    int ring_fd;
+    unsigned *sq_tail, *sq_mask, *sq_array;
+    unsigned *cq_head, *cq_tail, *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ring, *cq_ring;
+    size_t sq_ring_size, cq_ring_size, sqes_size;
+#endif
+    pthread_t worker;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    AioRequest *head, *tail;
+    int stop;
+};
+
+/**
+ * @brief Does (the rest of) a request synchronously.
+ *
+ * Writes are retried until everything is written; reads until the buffer is
+ * full or the end of the file, so a short read always means end of file.
+ *
+ * @param[in] req  The request.
+ * @param[in] done Bytes already transferred.
+ * @return Total bytes transferred, or -errno on failure.
+ */
+static ssize_t aio_perform(AioRequest *req, size_t done) {
+    while (done < req->len) {
+        char *buf = req->buf + done;
+        size_t len = req->len - done;
+        ssize_t n;
+        if (req->write)
+            n = req->offset < 0 ? write(req->fd, buf, len) : pwrite(req->fd, buf, len, req->offset + (off_t)done);
+        else
+            n = req->offset < 0 ? read(req->fd, buf, len) : pread(req->fd, buf, len, req->offset + (off_t)done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -errno;
+        }
+        if (n == 0) {
+            if (req->write) return -EIO;
+            break;
+        }
+        done += (size_t)n;
+    }
+    return (ssize_t)done;
+}
+
+/**
+ * @brief Completes a request whose asynchronous part returned res.
+ */
+static void aio_finish(AioRequest *req, ssize_t res) {
+    // finish short transfers synchronously so callers only see full blocks or end of file
+    if (res > 0 && (size_t)res < req->len) res = aio_perform(req, (size_t)res);
+    req->result = res;
+    req->state = AIO_DONE;
+}
+
+/**
+ * @brief Fallback worker: runs the queued requests in order with pread/pwrite.
+ */
+static void *aio_worker(void *arg) {
+    AioQueue *q = (AioQueue *)arg;
+    pthread_mutex_lock(&q->lock);
+    for (;;) {
+        while (!q->head && !q->stop) pthread_cond_wait(&q->cond, &q->lock);
+        AioRequest *req = q->head;
+        if (!req) break;
+        q->head = req->next;
+        if (!q->head) q->tail = NULL;
+        pthread_mutex_unlock(&q->lock);
+
+        ssize_t res = aio_perform(req, 0);
+
+        pthread_mutex_lock(&q->lock);
+        req->result = res;
+        req->state = AIO_DONE;
+        q->inflight--;
+        pthread_cond_broadcast(&q->cond);
+    }
+    pthread_mutex_unlock(&q->lock);
+    return NULL;
+}
+
+#ifdef HAVE_IO_URING
+/**
+ * @brief Sets up an io_uring with room for depth requests.
+ *
+ * @return 0 on success, or -1 if io_uring is unavailable or too old to read and write at the current file position.
+ */
+static int uring_setup(AioQueue *q, unsigned depth) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = (int)syscall(__NR_io_uring_setup, depth, &p);
+    if (fd < 0) return -1;
+    if (!(p.features & IORING_FEAT_RW_CUR_POS)) {
+        close(fd);
+        return -1;
+    }
+
+    q->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    q->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (q->cq_ring_size > q->sq_ring_size) q->sq_ring_size = q->cq_ring_size;
+        q->cq_ring_size = 0;
+    }
+    q->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+    q->sq_ring = mmap(NULL, q->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    q->cq_ring = q->cq_ring_size ? mmap(NULL, q->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING)
+                                 : q->sq_ring;
+    q->sqes = mmap(NULL, q->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (q->sq_ring == MAP_FAILED || q->cq_ring == MAP_FAILED || q->sqes == MAP_FAILED) {
+        if (q->sq_ring != MAP_FAILED) munmap(q->sq_ring, q->sq_ring_size);
+        if (q->cq_ring_size && q->cq_ring != MAP_FAILED) munmap(q->cq_ring, q->cq_ring_size);
+        if (q->sqes != MAP_FAILED) munmap(q->sqes, q->sqes_size);
+        close(fd);
+        return -1;
+    }
+
+    char *sq = (char *)q->sq_ring, *cq = (char *)q->cq_ring;
+    q->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+    q->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+    q->sq_array = (unsigned *)(sq + p.sq_off.array);
+    q->cq_head = (unsigned *)(cq + p.cq_off.head);
+    q->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+    q->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+    q->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+    q->ring_fd = fd;
+    q->depth = p.sq_entries;
+    return 0;
+}
+
+static void uring_teardown(AioQueue *q) {
+    munmap(q->sqes, q->sqes_size);
+    if (q->cq_ring_size) munmap(q->cq_ring, q->cq_ring_size);
+    munmap(q->sq_ring, q->sq_ring_size);
+    close(q->ring_fd);
+}
+
+/**
+ * @brief Takes one completion off the ring, waiting for it if none is ready.
+ *
+ * @return 0 on success, or -1 if io_uring_enter fails.
+ */
+static int uring_reap(AioQueue *q) {
+    unsigned head = *q->cq_head;
+    while (head == __atomic_load_n(q->cq_tail, __ATOMIC_ACQUIRE)) {
+        if (syscall(__NR_io_uring_enter, q->ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR) {
+            perror("io_uring_enter");
+            return -1;
+        }
+    }
+    struct io_uring_cqe *cqe = &q->cqes[head & *q->cq_mask];
+    AioRequest *req = (AioRequest *)(uintptr_t)cqe->user_data;
+    ssize_t res = cqe->res;
+    __atomic_store_n(q->cq_head, head + 1, __ATOMIC_RELEASE);
+    q->inflight--;
+    aio_finish(req, res);
+    return 0;
+}
+
+/**
+ * @brief Queues a request on the ring and tells the kernel about it.
+ *
+ * @return 0 on success, or -1 if io_uring_enter fails.
+ */
+static int uring_submit(AioQueue *q, AioRequest *req) {
+    if (q->inflight == q->depth && uring_reap(q) < 0) return -1;
+
+    unsigned tail = *q->sq_tail;
+    unsigned index = tail & *q->sq_mask;
+    struct io_uring_sqe *sqe = &q->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = req->write ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = req->fd;
+    sqe->addr = (uint64_t)(uintptr_t)req->buf;
+    sqe->len = req->len > AIO_MAX_SQE_LEN ? AIO_MAX_SQE_LEN : (unsigned)req->len;
+    sqe->off = (uint64_t)(int64_t)req->offset;
+    sqe->user_data = (uint64_t)(uintptr_t)req;
+    q->sq_array[index] = index;
+    __atomic_store_n(q->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    q->inflight++;
+
+    while (syscall(__NR_io_uring_enter, q->ring_fd, 1, 0, 0, NULL, 0) < 0) {
+        if (errno == EINTR) continue;
+        perror("io_uring_enter");
+        return -1;
+    }
+    return 0;
+}
+#endif
+
+/**
+ * @brief Creates a queue that keeps up to depth requests in flight.
+ *
+ * A queue must only be used from one thread at a time.
+ *
+ * @param[in] depth Number of requests in flight before aio_submit() waits for a completion.
+ * @return The queue, or NULL if neither io_uring nor the worker thread can be set up.
+ */
+AioQueue *aio_queue_create(unsigned depth) {
+    AioQueue *q = calloc(1, sizeof(AioQueue));
+    if (!q) {
+        perror("Memory allocation failed");
+        return NULL;
+    }
+    q->depth = depth ? depth : 1;
+
+#ifdef HAVE_IO_URING
+    const char *backend = getenv("QUICKSORT_AIO");
+    if (!(backend && strcmp(backend, "threads") == 0) && uring_setup(q, q->depth) == 0) {
+        q->uring = 1;
+        return q;
+    }
+#endif
+
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->cond, NULL);
+    if (pthread_create(&q->worker, NULL, aio_worker, q) != 0) {
+        fprintf(stderr, "Failed to start I/O thread\n");
+        pthread_mutex_destroy(&q->lock);
+        pthread_cond_destroy(&q->cond);
+        free(q);
+        return NULL;
+    }
+    return q;
+}
+
+/**
+ * @brief Waits for the requests still in flight and frees the queue.
+ */
+void aio_queue_destroy(AioQueue *q) {
+    if (!q) return;
+#ifdef HAVE_IO_URING
+    if (q->uring) {
+        while (q->inflight && uring_reap(q) == 0) {}
+        uring_teardown(q);
+        free(q);
+        return;
+    }
+#endif
+    pthread_mutex_lock(&q->lock);
+    q->stop = 1;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->lock);
+    pthread_join(q->worker, NULL);
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->cond);
+    free(q);
+}
+
+/**
+ * @brief Name of the backend the queue runs on, "io_uring" or "threads".
+ */
+const char *aio_queue_backend(const AioQueue *q) {
+    return q->uring ? "io_uring" : "threads";
+}
+
+/**
+ * @brief Starts a read or write. The request and its buffer must stay valid until aio_wait() returns for it.
+ *
+ * @return 0 on success, or -1 if the request could not be queued.
+ */
+int aio_submit(AioQueue *q, AioRequest *req) {
+    req->state = AIO_PENDING;
+    req->result = 0;
+    req->next = NULL;
+#ifdef HAVE_IO_URING
+    if (q->uring) {
+        if (uring_submit(q, req) < 0) {
+            req->state = AIO_IDLE;
+            return -1;
+        }
+        return 0;
+    }
+#endif
+    pthread_mutex_lock(&q->lock);
+    if (q->tail) q->tail->next = req;
+    else q->head = req;
+    q->tail = req;
+    q->inflight++;
+    pthread_cond_broadcast(&q->cond);
+    pthread_mutex_unlock(&q->lock);
+    return 0;
+}
+
+/**
+ * @brief Waits for a request to complete.
+ *
+ * @return Bytes transferred (less than requested only for a read that hit end of file), or -errno on failure.
+ */
+ssize_t aio_wait(AioQueue *q, AioRequest *req) {
+    if (req->state == AIO_IDLE) return req->result;
+#ifdef HAVE_IO_URING
+    if (q->uring) {
+        while (req->state != AIO_DONE)
+            if (uring_reap(q) < 0) return -EIO;
+        req->state = AIO_IDLE;
+        return req->result;
+    }
+#endif
+    pthread_mutex_lock(&q->lock);
+    while (req->state != AIO_DONE) pthread_cond_wait(&q->cond, &q->lock);
+    pthread_mutex_unlock(&q->lock);
+    req->state = AIO_IDLE;
+    return req->result;
+}
+
+/**
+ * @brief Starts reading a regular file from its current position with AIO_READ_AHEAD blocks in flight.
+ *
+ * Readers that are used from the same thread can share one queue, so that
+ * many open readers cost one io_uring (or one I/O thread) instead of one
+ * each. Every completion carries its AioRequest, which lives in the reader
+ * that submitted it, so waiting on a shared queue files the completions of
+ * other readers with them. The reader does not take ownership of fd.
+ *
+ * @param[in] queue Queue with room for AIO_READ_AHEAD requests per reader on it, or NULL to create one.
+ * @return 0 on success, or -1 if the queue or the blocks cannot be set up.
+ */
+int aio_reader_open(AioReader *r, AioQueue *queue, int fd, size_t block_size) {
+    memset(r, 0, sizeof(*r));
+    r->fd = fd;
+    r->block_size = block_size;
+    r->returned = -1;
+    r->offset = lseek(fd, 0, SEEK_CUR);
+    if (r->offset < 0) r->offset = 0;
+    r->owns_queue = !queue;
+    r->queue = queue ? queue : aio_queue_create(AIO_READ_AHEAD);
+    if (!r->queue) return -1;
+
+    for (int i = 0; i < AIO_READ_AHEAD; i++) {
+        r->blocks[i] = malloc(block_size);
+        if (!r->blocks[i]) {
+            perror("Memory allocation failed");
+            aio_reader_close(r);
+            return -1;
+        }
+    }
+    for (int i = 0; i < AIO_READ_AHEAD; i++) {
+        AioRequest req = {fd, 0, r->blocks[i], block_size, r->offset, 0, AIO_IDLE, NULL};
+        r->reqs[i] = req;
+        if (aio_submit(r->queue, &r->reqs[i]) < 0) {
+            aio_reader_close(r);
+            return -1;
+        }
+        r->offset += (off_t)block_size;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns the next block of the file and starts reading ahead into the block returned before it.
+ *
+ * @param[in]  r    The reader.
+ * @param[out] data Start of the block, valid until the next call.
+ * @param[out] len  Bytes in the block; 0 at end of file.
+ * @return 0 on success, or -1 on a read error.
+ */
+int aio_reader_next(AioReader *r, const char **data, size_t *len) {
+    if (r->returned >= 0 && !r->eof) {
+        AioRequest *req = &r->reqs[r->returned];
+        req->offset = r->offset;
+        if (aio_submit(r->queue, req) < 0) return -1;
+        r->offset += (off_t)r->block_size;
+    }
+    r->returned = -1;
+
+    AioRequest *req = &r->reqs[r->next];
+    if (req->state == AIO_IDLE) {
+        *len = 0;
+        return 0;
+    }
+    ssize_t n = aio_wait(r->queue, req);
+    if (n < 0) {
+        errno = (int)-n;
+        perror("Error reading file");
+        return -1;
+    }
+    if ((size_t)n < r->block_size) r->eof = 1;
+    *data = r->blocks[r->next];
+    *len = (size_t)n;
+    r->returned = r->next;
+    r->next = (r->next + 1) % AIO_READ_AHEAD;
+    return 0;
+}
+
+/**
+ * @brief Waits for the reads in flight and frees the reader. Does not close the file or a shared queue.
+ */
+void aio_reader_close(AioReader *r) {
+    if (r->queue) {
+        for (int i = 0; i < AIO_READ_AHEAD; i++) aio_wait(r->queue, &r->reqs[i]);
+        if (r->owns_queue) aio_queue_destroy(r->queue);
+    }
+    for (int i = 0; i < AIO_READ_AHEAD; i++) free(r->blocks[i]);
+    r->queue = NULL;
+}
+
+/**
+ * @brief Starts writing a file at its current position, or as a stream if it is not seekable.
+ *
+ * The writer does not take ownership of fd.
+ *
+ * @return 0 on success, or -1 if the queue or the buffers cannot be set up.
+ */
+int aio_writer_open(AioWriter *w, int fd, size_t block_size) {
+    memset(w, 0, sizeof(*w));
+    w->fd = fd;
+    w->block_size = block_size;
+    w->offset = lseek(fd, 0, SEEK_CUR);
+    w->blocks[0] = malloc(block_size);
+    w->blocks[1] = malloc(block_size);
+    if (!w->blocks[0] || !w->blocks[1]) {
+        perror("Memory allocation failed");
+        free(w->blocks[0]);
+        free(w->blocks[1]);
+        return -1;
+    }
+    w->queue = aio_queue_create(2);
+    if (!w->queue) {
+        free(w->blocks[0]);
+        free(w->blocks[1]);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Waits for the write of the other buffer, then starts writing the current one and switches buffers.
+ *
+ * Only one write is in flight at a time, which keeps the writes in order on pipes.
+ */
+static int aio_writer_submit(AioWriter *w) {
+    int other = 1 - w->current;
+    ssize_t n = aio_wait(w->queue, &w->reqs[other]);
+    if (n < 0) {
+        errno = (int)-n;
+        perror("Error writing file");
+        w->error = 1;
+    }
+    if (w->error) return -1;
+
+    AioRequest req = {w->fd, 1, w->blocks[w->current], w->len, w->offset, 0, AIO_IDLE, NULL};
+    w->reqs[w->current] = req;
+    if (aio_submit(w->queue, &w->reqs[w->current]) < 0) {
+        w->error = 1;
+        return -1;
+    }
+    if (w->offset >= 0) w->offset += (off_t)w->len;
+    w->current = other;
+    w->len = 0;
+    return 0;
+}
+
+/**
+ * @brief Appends len bytes, writing each buffer in the background once it is full.
+ *
+ * @return 0 on success, or -1 if an earlier write failed.
+ */
+int aio_writer_write(AioWriter *w, const void *data, size_t len) {
+    const char *p = (const char *)data;
+    while (len) {
+        size_t n = w->block_size - w->len;
+        if (n > len) n = len;
+        memcpy(w->blocks[w->current] + w->len, p, n);
+        w->len += n;
+        p += n;
+        len -= n;
+        if (w->len == w->block_size && aio_writer_submit(w) < 0) return -1;
+    }
+    return w->error ? -1 : 0;
+}
+
+/**
+ * @brief Writes what is buffered, waits for every write and frees the writer. Does not close the file.
+ *
+ * @return 0 if everything was written, or -1 on a write error.
+ */
+int aio_writer_close(AioWriter *w) {
+    if (w->len && !w->error) aio_writer_submit(w);
+    for (int i = 0; i < 2; i++) {
+        ssize_t n = aio_wait(w->queue, &w->reqs[i]);
+        if (n < 0 && !w->error) {
+            errno = (int)-n;
+            perror("Error writing file");
+            w->error = 1;
+        }
+    }
+    aio_queue_destroy(w->queue);
+    free(w->blocks[0]);
+    free(w->blocks[1]);
+    return w->error ? -1 : 0;
+}
@@ -0,0 +1,80 @@
+/*
+* @author   Jatin Jain
+* @file     aio.h
+* @desc     asynchronous file I/O for the external sort: an io_uring queue with a pread/pwrite worker thread fallback, plus a
+*           read-ahead reader and a double-buffered writer built on it.
+* @date     17 october 2026
+*/
+
+#ifndef AIO_H
+#define AIO_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#define AIO_READ_AHEAD 2                // blocks in flight per reader
+
+typedef struct AioQueue AioQueue;
+
+/**
+ * @brief One read or write. Owned by the caller and must stay alive until aio_wait() returns for it.
+ *
+ * offset -1 reads or writes at the current file position, for pipes and terminals.
+ */
+typedef struct AioRequest {
+    int fd;
+    int write;
+    char *buf;
+    size_t len;
+    off_t offset;
+    ssize_t result;
+    int state;
+    struct AioRequest *next;
+} AioRequest;
+
+/**
+ * @brief Sequential reader that keeps AIO_READ_AHEAD blocks in flight, on its own queue or on one it shares.
+ */
+typedef struct {
+    AioQueue *queue;
+    int owns_queue;
+    int fd;
+    off_t offset;
+    size_t block_size;
+    char *blocks[AIO_READ_AHEAD];
+    AioRequest reqs[AIO_READ_AHEAD];
+    int next;
+    int returned;
+    int eof;
+} AioReader;
+
+/**
+ * @brief Sequential writer with two buffers: one is filled while the other is written.
+ */
+typedef struct {
+    AioQueue *queue;
+    int fd;
+    off_t offset;
+    size_t block_size;
+    char *blocks[2];
+    AioRequest reqs[2];
+    int current;
+    size_t len;
+    int error;
+} AioWriter;
+
+AioQueue *aio_queue_create(unsigned depth);
+void aio_queue_destroy(AioQueue *queue);
+const char *aio_queue_backend(const AioQueue *queue);
+int aio_submit(AioQueue *queue, AioRequest *req);
+ssize_t aio_wait(AioQueue *queue, AioRequest *req);
+
+int aio_reader_open(AioReader *r, AioQueue *queue, int fd, size_t block_size);
+int aio_reader_next(AioReader *r, const char **data, size_t *len);
+void aio_reader_close(AioReader *r);
+
+int aio_writer_open(AioWriter *w, int fd, size_t block_size);
+int aio_writer_write(AioWriter *w, const void *data, size_t len);
+int aio_writer_close(AioWriter *w);
+
+#endif
@@ -0,0 +1,903 @@
+/*
+* @author   Jatin Jain
+* @file     bench.c
+* @desc     benchmark harness: generates inputs in memory for every distribution and size asked for, runs each sort engine on
+*           them several times and reports the median and 95th percentile wall time, the throughput, and the speedup and
+*           parallel efficiency of every engine over the serial quicksort. Besides the engines of quicksort.c it runs libc
+*           qsort() and the C++ standard library sorts as references. A scaling sweep runs the threaded engine at 1, 2, 4,
+*           ... threads up to the number of cores. In a weak sweep the input grows with the threads, and speedup and
+*           efficiency are taken against the serial quicksort on the base size, so efficiency is T(n) / T(p, p n). The
+*           untimed warm-up run of every engine also measures its memory: the allocations, bytes allocated and peak live
+*           bytes counted by memtrack, and the peak RSS of the process.
+* @usage    ./bench [-e engines] [-d distributions] [-n sizes] [-r runs] [-s seed] [-c cutoff] [-t threads]
+*                   [-S strong|weak] [-f table|csv|json] [-b baseline.json] [-T percent] [-R engine]
+* @date     17 october 2026
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "quicksort.h"
+#include "stlsort.h"
+#include "gen.h"
+#include "memtrack.h"
+#include "timing.h"
+#include "verify.h"
+
+#define MAX_SIZES 32
+#define MAX_THREAD_COUNTS 32
+
+enum { FORMAT_TABLE, FORMAT_CSV, FORMAT_JSON };
+enum { SCALING_NONE, SCALING_STRONG, SCALING_WEAK };
+enum { ENGINE_SERIAL, ENGINE_SWEPT, ENGINE_ALL_CORES };
+
+/**
+ * @brief One result of a baseline report, matched by engine, distribution, size and threads.
+ */
+typedef struct {
+    size_t report;                      // which report of the baseline file, from 0
+    char engine[32];
+    char distribution[32];
+    size_t size;
+    size_t threads;
+    double median;
+    double ci_low;
+    double ci_high;
+} BaselineRow;
+
+/**
+ * @brief A baseline report to check results against, and the outcome of the checks so far.
+ *
+ * A result regresses when its median is more than `threshold` (a fraction)
+ * above the baseline median and the confidence intervals of the two medians
+ * do not overlap, and does so again when it is timed a second time, so a
+ * slow run caused by noise alone does not fail the check. A result with no
+ * baseline row fails it. The baseline file may hold several reports one
+ * after another; a result is then compared with the slowest of them, which
+ * covers the drift between invocations that one report does not see.
+ * With a `reference` engine, every time is first divided by the median of
+ * that engine on the same input in the same report, so a machine that is
+ * uniformly faster or slower than when the baseline was recorded (another
+ * host, a busy neighbour, frequency scaling) does not count as a change.
+ */
+typedef struct {
+    BaselineRow *rows;
+    size_t count;
+    double threshold;
+    const char *reference;
+    size_t compared;
+    size_t rechecked;
+    size_t regressions;
+    size_t missing;
+} Baseline;
+
+/**
+ * @brief Settings of a benchmark run.
+ */
+typedef struct {
+    unsigned engines;                   // bit i selects engines[i]
+    unsigned distributions;             // bit i selects Distribution i
+    size_t sizes[MAX_SIZES];            // per thread in weak scaling
+    size_t size_count;
+    size_t threads[MAX_THREAD_COUNTS];  // thread counts of the threaded engine
+    size_t thread_count;
+    int runs;
+    uint64_t seed;
+    size_t cutoff;
+    int format;
+    int scaling;
+    Baseline *baseline;                 // NULL unless checking against a baseline
+} BenchConfig;
+
+/**
+ * @brief A sort engine under test: returns a newly allocated sorted copy of data, or NULL on failure.
+ *
+ * ENGINE_SWEPT engines run once per thread count of the config; the others
+ * run once, and are reported with 1 thread (ENGINE_SERIAL) or with the
+ * number of cores (ENGINE_ALL_CORES, engines that size their own pool).
+ */
+typedef struct {
+    const char *name;
+    int parallelism;
+    int *(*sort)(const int *data, size_t size, size_t threads, const BenchConfig *config);
+} BenchEngine;
+
+/**
+ * @brief Timings of one engine on one input.
+ *
+ * speedup and efficiency are relative to the quicksort median on the same
+ * input, or in weak scaling on the base size, and negative when quicksort
+ * was not run. The confidence interval
+ * of the median comes from the order statistics of the runs, so it needs no
+ * assumption about how the times are distributed. memory is measured on
+ * the warm-up run, so the counting never lands in the timings.
+ */
+typedef struct {
+    const char *engine;
+    Distribution dist;
+    size_t size;
+    size_t threads;
+    int runs;
+    double median;
+    double ci_low;                      // 95% confidence interval of the median
+    double ci_high;
+    double p95;
+    double speedup;
+    double efficiency;
+    MemUsage memory;
+} BenchResult;
+
+static int *run_quicksort(const int *data, size_t size, size_t threads, const BenchConfig *config) {
+    (void)threads;
+    (void)config;
+    return quicksort(size, data);
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int *run_qsort(const int *data, size_t size, size_t threads, const BenchConfig *config) {
+    (void)threads;
+    (void)config;
+    int *copy = memtrack_malloc(size * sizeof(int));
+    if (!copy) return NULL;
+    memcpy(copy, data, size * sizeof(int));
+    qsort(copy, size, sizeof(int), compare_ints);
+    return copy;
+}
+
+static int *run_std_sort(const int *data, size_t size, size_t threads, const BenchConfig *config) {
+    (void)threads;
+    (void)config;
+    return stl_sort(data, size);
+}
+
+static int *run_std_stable_sort(const int *data, size_t size, size_t threads, const BenchConfig *config) {
+    (void)threads;
+    (void)config;
+    return stl_stable_sort(data, size);
+}
+
+static int *run_std_sort_par(const int *data, size_t size, size_t threads, const BenchConfig *config) {
+    (void)threads;
+    (void)config;
+    return stl_sort_par(data, size);
+}
+
+static int *run_std_stable_sort_par(const int *data, size_t size, size_t threads, const BenchConfig *config) {
+    (void)threads;
+    (void)config;
+    return stl_stable_sort_par(data, size);
+}
+
+static int *run_quicksort_threaded(const int *data, size_t size, size_t threads, const BenchConfig *config) {
+    ThreadArgs args = {(int *)data, size, config->cutoff, threads, 0, 0, {0}};
+    pthread_t thread;
+    void *sorted = NULL;
+    if (pthread_create(&thread, NULL, quicksort_threaded, &args) != 0) return NULL;
+    pthread_join(thread, &sorted);
+    return (int *)sorted;
+}
+
+static int *run_radix(const int *data, size_t size, size_t threads, const BenchConfig *config) {
+    (void)config;
+    Sorter *sorter = sorter_create();
+    int *copy = memtrack_malloc(size * sizeof(int));
+    if (!sorter || !copy) {
+        sorter_destroy(sorter);
+        free(copy);
+        return NULL;
+    }
+    memcpy(copy, data, size * sizeof(int));
+    sorter_set_threads(sorter, threads);
+    int status = sorter_sort_int32(sorter, (int32_t *)copy, size);
+    sorter_destroy(sorter);
+    if (status < 0) {
+        free(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+// quicksort must stay first: the other engines are reported relative to it
+static const BenchEngine engines[] = {
+    {"quicksort", ENGINE_SERIAL, run_quicksort},
+    {"quicksort_threaded", ENGINE_SWEPT, run_quicksort_threaded},
+    {"radix", ENGINE_SWEPT, run_radix},
+    {"qsort", ENGINE_SERIAL, run_qsort},
+    {"std_sort", ENGINE_SERIAL, run_std_sort},
+    {"std_stable_sort", ENGINE_SERIAL, run_std_stable_sort},
+    {"std_sort_par", ENGINE_ALL_CORES, run_std_sort_par},
+    {"std_stable_sort_par", ENGINE_ALL_CORES, run_std_stable_sort_par},
+};
+#define ENGINE_COUNT (sizeof(engines) / sizeof(engines[0]))
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Parses a size such as 1000, 10K, 5M or 1B (decimal multipliers; G is the same as B).
+ *
+ * @return 0 on success, or -1 if the size is malformed.
+ */
+static int parse_size(const char *text, size_t *size) {
+    char *end;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text) return -1;
+    switch (*end) {
+    case 'k': case 'K': value *= 1000ull; end++; break;
+    case 'm': case 'M': value *= 1000000ull; end++; break;
+    case 'b': case 'B': case 'g': case 'G': value *= 1000000000ull; end++; break;
+    default: break;
+    }
+    if (*end != '\0' || value == 0) return -1;
+    *size = (size_t)value;
+    return 0;
+}
+
+/**
+ * @brief Parses a comma separated list of sizes.
+ *
+ * @param[in]  list  The list; modified in place.
+ * @param[out] sizes Receives at most max sizes.
+ * @param[out] count Number of sizes parsed.
+ * @return 0 on success, or -1 on a malformed size or too many sizes.
+ */
+static int parse_sizes(char *list, size_t *sizes, size_t max, size_t *count) {
+    *count = 0;
+    for (char *item = strtok(list, ","); item; item = strtok(NULL, ",")) {
+        if (*count == max || parse_size(item, &sizes[*count]) < 0) {
+            fprintf(stderr, "Invalid size: %s\n", item);
+            return -1;
+        }
+        (*count)++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Parses a comma separated list of names into a bit set.
+ *
+ * @param[in]  list   The list; modified in place.
+ * @param[in]  lookup Maps one name to its bit index, or returns -1.
+ * @param[out] set    The selected bits.
+ * @return 0 on success, or -1 on an unknown name.
+ */
+static int parse_names(char *list, int (*lookup)(const char *), unsigned *set) {
+    *set = 0;
+    for (char *name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        int index = lookup(name);
+        if (index < 0) {
+            fprintf(stderr, "Unknown name: %s\n", name);
+            return -1;
+        }
+        *set |= 1u << index;
+    }
+    return 0;
+}
+
+static int lookup_engine(const char *name) {
+    for (size_t i = 0; i < ENGINE_COUNT; i++)
+        if (strcmp(name, engines[i].name) == 0) return (int)i;
+    return -1;
+}
+
+static int lookup_distribution(const char *name) {
+    Distribution dist;
+    return gen_lookup(name, &dist) < 0 ? -1 : (int)dist;
+}
+
+/**
+ * @brief Number of online cores, at least 1.
+ */
+static size_t core_count(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (size_t)cores : 1;
+}
+
+/**
+ * @brief Prints the header of the report, before any result.
+ */
+static void print_header(const BenchConfig *config) {
+    if (config->format == FORMAT_CSV)
+        printf("engine,distribution,size,threads,runs,median_s,ci_low_s,ci_high_s,p95_s,elements_per_s,speedup,efficiency,"
+               "allocations,bytes_allocated,peak_live_bytes,max_rss_kib\n");
+    else if (config->format == FORMAT_JSON)
+        printf("{\n  \"cores\": %zu,\n  \"scaling\": \"%s\",\n  \"results\": [", core_count(),
+               config->scaling == SCALING_WEAK ? "weak" : config->scaling == SCALING_STRONG ? "strong" : "none");
+    else
+        printf("%-20s %-12s %12s %7s %5s %12s %12s %10s %8s %10s %10s %10s %10s\n", "Engine", "Distribution", "Size",
+               "Threads", "Runs", "Median (s)", "p95 (s)", "Melem/s", "Speedup", "Efficiency", "Allocs", "Peak MiB",
+               "RSS MiB");
+}
+
+/**
+ * @brief Prints one result in the configured format.
+ *
+ * @param first Nonzero for the first result of the report (JSON needs no separator before it).
+ */
+static void print_result(const BenchConfig *config, const BenchResult *r, int first) {
+    double throughput = r->median > 0.0 ? (double)r->size / r->median : 0.0;
+    int relative = r->speedup >= 0.0;
+    const MemUsage *m = &r->memory;
+
+    if (config->format == FORMAT_CSV) {
+        printf("%s,%s,%zu,%zu,%d,%.9f,%.9f,%.9f,%.9f,%.1f,", r->engine, gen_name(r->dist), r->size, r->threads,
+               r->runs, r->median, r->ci_low, r->ci_high, r->p95, throughput);
+        if (relative) printf("%.4f,%.4f,", r->speedup, r->efficiency);
+        else printf(",,");
+        printf("%zu,%zu,%zu,%ld\n", m->allocations, m->bytes_allocated, m->peak_live_bytes, m->max_rss_kib);
+    } else if (config->format == FORMAT_JSON) {
+        printf("%s\n    {\"engine\": \"%s\", \"distribution\": \"%s\", \"size\": %zu, \"threads\": %zu, \"runs\": %d, "
+               "\"median_s\": %.9f, \"ci_low_s\": %.9f, \"ci_high_s\": %.9f, \"p95_s\": %.9f, \"elements_per_s\": %.1f, ",
+               first ? "" : ",", r->engine, gen_name(r->dist), r->size, r->threads, r->runs, r->median, r->ci_low,
+               r->ci_high, r->p95, throughput);
+        if (relative) printf("\"speedup\": %.4f, \"efficiency\": %.4f, ", r->speedup, r->efficiency);
+        else printf("\"speedup\": null, \"efficiency\": null, ");
+        printf("\"allocations\": %zu, \"bytes_allocated\": %zu, \"peak_live_bytes\": %zu, \"max_rss_kib\": %ld}",
+               m->allocations, m->bytes_allocated, m->peak_live_bytes, m->max_rss_kib);
+    } else {
+        printf("%-20s %-12s %12zu %7zu %5d %12.6f %12.6f %10.2f ", r->engine, gen_name(r->dist), r->size, r->threads,
+               r->runs, r->median, r->p95, throughput / 1e6);
+        if (relative) printf("%8.2f %10.2f ", r->speedup, r->efficiency);
+        else printf("%8s %10s ", "-", "-");
+        printf("%10zu %10.1f ", m->allocations, (double)m->peak_live_bytes / (1 << 20));
+        if (m->max_rss_kib >= 0) printf("%10.1f\n", (double)m->max_rss_kib / 1024.0);
+        else printf("%10s\n", "-");
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Prints the end of the report, after the last result.
+ */
+static void print_footer(const BenchConfig *config) {
+    if (config->format == FORMAT_JSON) printf("\n  ]\n}\n");
+}
+
+/**
+ * @brief Finds the value of a key in one line of a JSON report written by this program.
+ *
+ * @return The first character of the value, or NULL if the key is not on the line.
+ */
+static const char *json_value(const char *line, const char *key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char *p = strstr(line, pattern);
+    return p ? p + strlen(pattern) : NULL;
+}
+
+static int json_string(const char *line, const char *key, char *out, size_t capacity) {
+    const char *value = json_value(line, key);
+    if (!value || *value != '"') return -1;
+    size_t len = strcspn(++value, "\"");
+    if (len >= capacity) return -1;
+    memcpy(out, value, len);
+    out[len] = '\0';
+    return 0;
+}
+
+static int json_number(const char *line, const char *key, double *out) {
+    const char *value = json_value(line, key);
+    if (!value) return -1;
+    char *end;
+    *out = strtod(value, &end);
+    return end == value ? -1 : 0;
+}
+
+/**
+ * @brief Loads the results of one or more JSON reports written with -f json, one after another.
+ *
+ * @return 0 on success, or -1 if the file cannot be read or a result is malformed.
+ */
+static int baseline_load(Baseline *baseline, const char *path) {
+    FILE *in = fopen(path, "r");
+    if (!in) {
+        perror("Error opening baseline");
+        return -1;
+    }
+    size_t capacity = 0, reports = 0;
+    char line[1024];
+    while (fgets(line, sizeof(line), in)) {
+        if (strstr(line, "\"results\"")) reports++;
+        if (!strstr(line, "\"engine\"")) continue;
+        BaselineRow row;
+        double size, threads;
+        if (json_string(line, "engine", row.engine, sizeof(row.engine)) < 0 ||
+            json_string(line, "distribution", row.distribution, sizeof(row.distribution)) < 0 ||
+            json_number(line, "size", &size) < 0 || json_number(line, "threads", &threads) < 0 ||
+            json_number(line, "median_s", &row.median) < 0 || json_number(line, "ci_low_s", &row.ci_low) < 0 ||
+            json_number(line, "ci_high_s", &row.ci_high) < 0) {
+            fprintf(stderr, "Malformed baseline result: %s", line);
+            fclose(in);
+            return -1;
+        }
+        row.report = reports ? reports - 1 : 0;
+        row.size = (size_t)size;
+        row.threads = (size_t)threads;
+        if (baseline->count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            BaselineRow *grown = realloc(baseline->rows, capacity * sizeof(BaselineRow));
+            if (!grown) {
+                perror("Memory allocation failed");
+                fclose(in);
+                return -1;
+            }
+            baseline->rows = grown;
+        }
+        baseline->rows[baseline->count++] = row;
+    }
+    fclose(in);
+    return 0;
+}
+
+static int baseline_matches(const BaselineRow *b, const char *engine, Distribution dist, size_t size) {
+    return strcmp(b->engine, engine) == 0 && strcmp(b->distribution, gen_name(dist)) == 0 && b->size == size;
+}
+
+/**
+ * @brief The row of an engine on an input in one report of the baseline, with any threads, or NULL.
+ */
+static const BaselineRow *baseline_find(const Baseline *baseline, const char *engine, Distribution dist, size_t size,
+                                        size_t report) {
+    for (size_t i = 0; i < baseline->count; i++) {
+        const BaselineRow *b = &baseline->rows[i];
+        if (b->report == report && baseline_matches(b, engine, dist, size)) return b;
+    }
+    return NULL;
+}
+
+/**
+ * @brief A result and its baseline on one scale: relative to the reference engine, or in seconds.
+ */
+typedef struct {
+    double median, ci_low, ci_high;
+    double base, base_low, base_high;
+} BaselineComparison;
+
+/**
+ * @brief Puts a result and its baseline on one scale.
+ *
+ * With several reports in the baseline, the base is the slowest of their medians and its interval runs from the
+ * lowest to the highest of their bounds.
+ *
+ * @param ref The result of the reference engine on the same input, or NULL when comparing absolute times.
+ * @return 1 if the result regressed, 0 if it did not, or -1 if it has no baseline.
+ */
+static int baseline_compare(const Baseline *baseline, const BenchResult *r, const BenchResult *ref,
+                            BaselineComparison *c) {
+    if (baseline->reference && (!ref || ref->median <= 0.0)) return -1;
+    int found = 0;
+    for (size_t i = 0; i < baseline->count; i++) {
+        const BaselineRow *row = &baseline->rows[i];
+        if (row->threads != r->threads || !baseline_matches(row, r->engine, r->dist, r->size)) continue;
+        double then = 1.0;              // scale that takes out the speed of the machine that recorded the report
+        if (baseline->reference) {
+            const BaselineRow *row_ref = baseline_find(baseline, baseline->reference, r->dist, r->size, row->report);
+            if (!row_ref || row_ref->median <= 0.0) continue;
+            then = 1.0 / row_ref->median;
+        }
+        if (!found || row->median * then > c->base) c->base = row->median * then;
+        if (!found || row->ci_low * then < c->base_low) c->base_low = row->ci_low * then;
+        if (!found || row->ci_high * then > c->base_high) c->base_high = row->ci_high * then;
+        found = 1;
+    }
+    if (!found) return -1;
+
+    double now = baseline->reference ? 1.0 / ref->median : 1.0;
+    c->median = r->median * now;
+    c->ci_low = r->ci_low * now;
+    c->ci_high = r->ci_high * now;
+    return c->median > c->base * (1.0 + baseline->threshold) && c->ci_low > c->base_high;
+}
+
+/**
+ * @brief Compares a result with its baseline, printing a line to stderr if it regressed or has no baseline.
+ *
+ * A result without a baseline fails too: a renamed engine or distribution,
+ * or a changed size list, must not turn the check off unnoticed.
+ *
+ * @param ref The result of the reference engine on the same input, or NULL when comparing absolute times.
+ * @return 1 if the result regressed or has no baseline, 0 otherwise.
+ */
+static int baseline_check(Baseline *baseline, const BenchResult *r, const BenchResult *ref) {
+    BaselineComparison c;
+    int verdict = baseline_compare(baseline, r, ref, &c);
+    if (verdict < 0) {
+        fprintf(stderr, "No baseline for %s on %s input of %zu elements with %zu threads\n", r->engine,
+                gen_name(r->dist), r->size, r->threads);
+        baseline->missing++;
+        return 1;
+    }
+    baseline->compared++;
+    if (!verdict) return 0;
+    fprintf(stderr, "Regression: %s on %s input of %zu elements with %zu threads: %s %.6f [%.6f, %.6f] "
+            "against %.6f [%.6f, %.6f] (%+.1f%%)\n", r->engine, gen_name(r->dist), r->size, r->threads,
+            baseline->reference ? "relative median" : "median (s)", c.median, c.ci_low, c.ci_high, c.base,
+            c.base_low, c.base_high, 100.0 * (c.median / c.base - 1.0));
+    baseline->regressions++;
+    return 1;
+}
+
+/**
+ * @brief Runs one engine on one input config->runs times after a warm-up run, checking every result against the input
+ *        outside the timed region.
+ *
+ * @param[in]  expected Checksum of the input.
+ * @param[out] result   Receives the engine, input, thread count, timings and memory usage.
+ * @param[in]  times  Scratch space for config->runs timings.
+ * @return 0 on success, or -1 if the engine fails or returns an unsorted result.
+ */
+static int bench_engine(const BenchEngine *engine, Distribution dist, const int *input, size_t size, size_t threads,
+                        const Checksum *expected, const BenchConfig *config, double *times, BenchResult *result) {
+    // one untimed run first, so page faults of a fresh heap and cold caches do not land in the timings; it is the
+    // run whose memory is measured
+    memtrack_reset();
+    memtrack_enable(1);
+    int *warm = engine->sort(input, size, threads, config);
+    memtrack_enable(0);
+    memtrack_read(&result->memory);
+    free(warm);
+    for (int run = 0; run < config->runs; run++) {
+        double start = timing_wall();
+        int *sorted = engine->sort(input, size, threads, config);
+        times[run] = timing_wall() - start;
+        int ok = sorted && verify_sorted_permutation(sorted, size, expected, core_count()) == 0;
+        free(sorted);
+        if (!ok) {
+            fprintf(stderr, "%s failed on %s input of %zu elements\n", engine->name, gen_name(dist), size);
+            return -1;
+        }
+    }
+
+    qsort(times, (size_t)config->runs, sizeof(double), compare_doubles);
+    int n = config->runs;
+    result->engine = engine->name;
+    result->dist = dist;
+    result->size = size;
+    result->threads = threads;
+    result->runs = n;
+    result->median = n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2.0;
+    // ranks of the order statistics bounding the median with 95% confidence (normal approximation of the binomial)
+    double spread = 1.96 * sqrt((double)n) / 2.0;
+    int low = (int)floor(n / 2.0 - spread), high = (int)ceil(n / 2.0 + spread) - 1;
+    result->ci_low = times[low < 0 ? 0 : low];
+    result->ci_high = times[high > n - 1 ? n - 1 : high];
+    result->p95 = times[(95 * n + 99) / 100 - 1];
+    result->speedup = -1.0;
+    result->efficiency = -1.0;
+    return 0;
+}
+
+/**
+ * @brief Runs the engine of a result again on the same input, with the same thread count.
+ *
+ * @return 0 on success, or -1 if the engine fails or is unknown.
+ */
+static int bench_rerun(const BenchResult *r, const int *input, const Checksum *expected, const BenchConfig *config,
+                       double *times, BenchResult *again) {
+    for (size_t e = 0; e < ENGINE_COUNT; e++)
+        if (strcmp(engines[e].name, r->engine) == 0)
+            return bench_engine(&engines[e], r->dist, input, r->size, r->threads, expected, config, times, again);
+    return -1;
+}
+
+/**
+ * @brief Generates one input and runs every selected engine on it, the threaded ones at each of the given thread counts.
+ *
+ * quicksort runs first when selected, so the others can be reported relative to it. In weak scaling they are
+ * reported relative to the quicksort time on the base size instead: the speedup is how many times faster than that
+ * the engine gets through size / base_size times the elements, and the efficiency is the speedup per thread.
+ *
+ * @param[in,out] base_time Median of the serial quicksort on base_size elements in weak scaling, negative while
+ *                          unknown; set from this input's quicksort when size is base_size.
+ * @param[in]     base_size Elements per thread in weak scaling, or 0 to report against quicksort on this input.
+ * @param[in,out] first     Nonzero until the first result has been printed.
+ * @return 0 on success, 1 if an engine failed, or -1 if the input cannot be allocated.
+ */
+static int bench_input(Distribution dist, size_t size, const size_t *threads, size_t thread_count, double *base_time,
+                       size_t base_size, const BenchConfig *config, double *times, int *first) {
+    int *input = malloc(size * sizeof(int));
+    if (!input || gen_fill(dist, input, size, config->seed) < 0) {
+        if (!input) perror("Memory allocation failed");
+        free(input);
+        return -1;
+    }
+
+    Checksum expected;
+    checksum_init(&expected);
+    for (size_t i = 0; i < size; i++) checksum_add(&expected, input[i]);
+
+    BenchResult results[ENGINE_COUNT * MAX_THREAD_COUNTS];
+    size_t result_count = 0;
+    int status = 0;
+    double serial = -1.0;
+    for (size_t e = 0; e < ENGINE_COUNT; e++) {
+        if (!(config->engines & (1u << e))) continue;
+        int swept = engines[e].parallelism == ENGINE_SWEPT;
+        size_t runs = swept ? thread_count : 1;
+        for (size_t t = 0; t < runs; t++) {
+            size_t count = swept ? threads[t] : engines[e].parallelism == ENGINE_ALL_CORES ? core_count() : 1;
+            BenchResult result;
+            if (bench_engine(&engines[e], dist, input, size, count, &expected, config, times, &result) < 0) {
+                status = 1;
+                continue;
+            }
+            if (e == 0) serial = result.median;          // engines[0] is the serial quicksort
+            if (e == 0 && base_size == size) *base_time = serial;
+            double scale = base_size ? (double)size / (double)base_size : 1.0;
+            double reference = base_size ? *base_time : serial;
+            if (reference > 0.0 && result.median > 0.0) {
+                result.speedup = scale * reference / result.median;
+                result.efficiency = result.speedup / (double)(count ? count : core_count());
+            }
+            print_result(config, &result, *first);
+            *first = 0;
+            results[result_count++] = result;
+        }
+    }
+
+    // checked once every engine has run, so the reference engine has a time whatever its place in the table
+    if (config->baseline) {
+        Baseline *baseline = config->baseline;
+        const BenchResult *ref = NULL;
+        for (size_t i = 0; i < result_count && baseline->reference; i++)
+            if (strcmp(results[i].engine, baseline->reference) == 0) ref = &results[i];
+        for (size_t i = 0; i < result_count; i++) {
+            const BenchResult *r = &results[i], *r_ref = ref;
+            BenchResult again, ref_again;
+            BaselineComparison c;
+            // the confidence interval of one invocation does not cover the drift between invocations (placement in
+            // memory, frequency, neighbours), so a row that looks slower is timed again with its reference, and only
+            // fails if it is slower again
+            if (baseline_compare(baseline, r, ref, &c) > 0) {
+                fprintf(stderr, "Rechecking %s on %s input of %zu elements with %zu threads (%+.1f%%)\n", r->engine,
+                        gen_name(dist), size, r->threads, 100.0 * (c.median / c.base - 1.0));
+                if (bench_rerun(r, input, &expected, config, times, &again) < 0 ||
+                    (ref && bench_rerun(ref, input, &expected, config, times, &ref_again) < 0)) {
+                    status = 1;
+                    continue;
+                }
+                r = &again;
+                r_ref = ref ? &ref_again : NULL;
+                baseline->rechecked++;
+            }
+            if (baseline_check(baseline, r, r_ref)) status = 1;
+        }
+    }
+
+    free(input);
+    return status;
+}
+
+/**
+ * @brief Median of the serial quicksort on a base-size input, the reference of a weak scaling sweep.
+ *
+ * @return The median, or -1 if quicksort is not selected or fails, or the input cannot be allocated.
+ */
+static double weak_base_time(Distribution dist, size_t size, const BenchConfig *config, double *times) {
+    if (!(config->engines & 1u)) return -1.0;
+    int *input = malloc(size * sizeof(int));
+    if (!input || gen_fill(dist, input, size, config->seed) < 0) {
+        if (!input) perror("Memory allocation failed");
+        free(input);
+        return -1.0;
+    }
+    Checksum expected;
+    checksum_init(&expected);
+    for (size_t i = 0; i < size; i++) checksum_add(&expected, input[i]);
+    BenchResult result;
+    int failed = bench_engine(&engines[0], dist, input, size, 1, &expected, config, times, &result) < 0;
+    free(input);
+    return failed ? -1.0 : result.median;
+}
+
+/**
+ * @brief Benchmark entry point.
+ *
+ * Usage:
+ *   ./bench [-e engines] [-d distributions] [-n sizes] [-r runs] [-s seed] [-c cutoff] [-t threads]
+ *           [-S strong|weak] [-f table|csv|json] [-b baseline.json] [-T percent] [-R engine]
+ *
+ * - `-e` comma separated engines (default all): quicksort, quicksort_threaded, radix, and the references qsort,
+ *   std_sort, std_stable_sort, std_sort_par and std_stable_sort_par (std::execution::par).
+ * - `-d` comma separated distributions (default all): uniform, sorted, reverse, organ_pipe,
+ *   sawtooth, few_unique, all_equal, zipf, gaussian.
+ * - `-n` comma separated sizes, with optional K, M or B suffix (default 1K,10K,100K,1M).
+ * - `-r` runs per engine and input (default 5).
+ * - `-s` seed of the random inputs (default 1).
+ * - `-c` serial cutoff of quicksort_threaded (default 16384).
+ * - `-t` comma separated thread counts of quicksort_threaded, 0 for unlimited (default the number of
+ *   cores, or 1, 2, 4, ... up to the number of cores in a scaling sweep).
+ * - `-S` scaling sweep: strong keeps each size fixed as the threads grow, weak multiplies each size
+ *   by the thread count so every thread has the same amount of work. Weak speedup and efficiency are
+ *   against the serial quicksort on the base size: efficiency at p threads is T(n) / T(p, p n).
+ * - `-f` output format: an aligned table with throughput in millions of elements per second,
+ *   or csv or json with throughput in elements per second.
+ * - `-b` checks every result against a report written earlier with -f json, and fails if any regressed
+ *   (a result that looks slower is timed again and fails only if it is slower again) or has no baseline.
+ *   The file may hold several reports one after another; each result is compared with the slowest.
+ * - `-T` how much slower than the baseline median a result may be, in percent (default 10), before its
+ *   confidence interval is compared with the baseline's.
+ * - `-R` compares times relative to this engine's on the same input instead of absolute times, which
+ *   must then run in both reports (e.g. std_sort).
+ *
+ * @return 0 on success, or 1 on a usage error, a failed engine or a regression.
+ */
+int main(int argc, char *argv[]) {
+    BenchConfig config;
+    memset(&config, 0, sizeof(config));
+    config.engines = (1u << ENGINE_COUNT) - 1;
+    config.distributions = (1u << DIST_COUNT) - 1;
+    config.runs = 5;
+    config.seed = 1;
+    config.cutoff = 16384;
+    Baseline baseline;
+    memset(&baseline, 0, sizeof(baseline));
+    baseline.threshold = 0.10;
+    const char *baseline_path = NULL;
+    const char *usage = "Usage: %s [-e engines] [-d distributions] [-n sizes] [-r runs] [-s seed] [-c cutoff] "
+                        "[-t threads] [-S strong|weak] [-f table|csv|json] [-b baseline.json] [-T percent] "
+                        "[-R engine]\n";
+    int opt;
+
+    while ((opt = getopt(argc, argv, "e:d:n:r:s:c:t:S:f:b:T:R:")) != -1) {
+        switch (opt) {
+        case 'e':
+            if (parse_names(optarg, lookup_engine, &config.engines) < 0) return 1;
+            break;
+        case 'd':
+            if (parse_names(optarg, lookup_distribution, &config.distributions) < 0) return 1;
+            break;
+        case 'n':
+            if (parse_sizes(optarg, config.sizes, MAX_SIZES, &config.size_count) < 0) return 1;
+            break;
+        case 'r':
+            config.runs = atoi(optarg);
+            if (config.runs < 1) {
+                fprintf(stderr, "Invalid number of runs: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 's':
+            config.seed = strtoull(optarg, NULL, 10);
+            break;
+        case 'c':
+            config.cutoff = strtoull(optarg, NULL, 10);
+            break;
+        case 't':
+            config.thread_count = 0;
+            for (char *item = strtok(optarg, ","); item; item = strtok(NULL, ",")) {
+                char *end;
+                unsigned long long threads = strtoull(item, &end, 10);
+                if (end == item || *end != '\0' || config.thread_count == MAX_THREAD_COUNTS) {
+                    fprintf(stderr, "Invalid thread count: %s\n", item);
+                    return 1;
+                }
+                config.threads[config.thread_count++] = (size_t)threads;
+            }
+            break;
+        case 'S':
+            if (strcmp(optarg, "strong") == 0) config.scaling = SCALING_STRONG;
+            else if (strcmp(optarg, "weak") == 0) config.scaling = SCALING_WEAK;
+            else {
+                fprintf(stderr, usage, argv[0]);
+                return 1;
+            }
+            break;
+        case 'b':
+            baseline_path = optarg;
+            break;
+        case 'R':
+            if (lookup_engine(optarg) < 0) {
+                fprintf(stderr, "Unknown name: %s\n", optarg);
+                return 1;
+            }
+            baseline.reference = optarg;
+            break;
+        case 'T': {
+            char *end;
+            double percent = strtod(optarg, &end);
+            if (end == optarg || *end != '\0' || percent < 0.0) {
+                fprintf(stderr, "Invalid threshold: %s\n", optarg);
+                return 1;
+            }
+            baseline.threshold = percent / 100.0;
+            break;
+        }
+        case 'f':
+            if (strcmp(optarg, "table") == 0) config.format = FORMAT_TABLE;
+            else if (strcmp(optarg, "csv") == 0) config.format = FORMAT_CSV;
+            else if (strcmp(optarg, "json") == 0) config.format = FORMAT_JSON;
+            else {
+                fprintf(stderr, usage, argv[0]);
+                return 1;
+            }
+            break;
+        default:
+            fprintf(stderr, usage, argv[0]);
+            return 1;
+        }
+    }
+    if (optind != argc) {
+        fprintf(stderr, usage, argv[0]);
+        return 1;
+    }
+    if (config.size_count == 0) {
+        const size_t defaults[] = {1000, 10000, 100000, 1000000};
+        memcpy(config.sizes, defaults, sizeof(defaults));
+        config.size_count = sizeof(defaults) / sizeof(defaults[0]);
+    }
+    if (config.thread_count == 0) {
+        size_t cores = core_count();
+        if (config.scaling == SCALING_NONE) config.threads[config.thread_count++] = cores;
+        else {
+            for (size_t t = 1; t < cores && config.thread_count < MAX_THREAD_COUNTS - 1; t *= 2)
+                config.threads[config.thread_count++] = t;
+            config.threads[config.thread_count++] = cores;
+        }
+    }
+
+    if (baseline_path) {
+        if (baseline_load(&baseline, baseline_path) < 0) {
+            free(baseline.rows);
+            return 1;
+        }
+        config.baseline = &baseline;
+    }
+
+    double *times = malloc((size_t)config.runs * sizeof(double));
+    if (!times) {
+        perror("Memory allocation failed");
+        free(baseline.rows);
+        return 1;
+    }
+    print_header(&config);
+
+    int status = 0, first = 1;
+    for (int d = 0; d < DIST_COUNT && status >= 0; d++) {
+        if (!(config.distributions & (1u << d))) continue;
+        for (size_t s = 0; s < config.size_count && status >= 0; s++) {
+            if (config.scaling != SCALING_WEAK) {
+                double unused = -1.0;
+                int rc = bench_input((Distribution)d, config.sizes[s], config.threads, config.thread_count, &unused, 0,
+                                     &config, times, &first);
+                status = rc < 0 ? rc : status | rc;
+                continue;
+            }
+            // weak scaling: one input per thread count, sized to keep the work per thread fixed, all measured against
+            // the serial quicksort on the base size, which the 1-thread input measures when the sweep has one
+            double base_time = -1.0;
+            int has_base = 0;
+            for (size_t t = 0; t < config.thread_count; t++) has_base |= config.threads[t] == 1;
+            if (!has_base) base_time = weak_base_time((Distribution)d, config.sizes[s], &config, times);
+            for (size_t t = 0; t < config.thread_count && status >= 0; t++) {
+                size_t threads = config.threads[t] ? config.threads[t] : core_count();
+                int rc = bench_input((Distribution)d, config.sizes[s] * threads, &config.threads[t], 1, &base_time,
+                                     config.sizes[s], &config, times, &first);
+                status = rc < 0 ? rc : status | rc;
+            }
+        }
+    }
+
+    print_footer(&config);
+    if (config.baseline)
+        fprintf(stderr, "Baseline check: %zu compared, %zu rechecked, %zu regressed, %zu without baseline "
+                "(threshold %.1f%%%s%s)\n", baseline.compared, baseline.rechecked, baseline.regressions,
+                baseline.missing, 100.0 * baseline.threshold,
+                baseline.reference ? ", relative to " : "", baseline.reference ? baseline.reference : "");
+    free(baseline.rows);
+    free(times);
+    return status != 0;
+}
@@ -0,0 +1,235 @@
+/*
+* @author   Jatin Jain
+* @file     cmpsort.c
+* @desc     stable quicksort of fixed-size elements under a caller's comparator. Like the int engine, each level splits its
+*           elements into less, equal and more than the pivot without reordering them within a part, which makes the sort
+*           stable; here the split is done through one scratch buffer and one class byte per element allocated up front,
+*           and the parts are copied back in place, so the sort allocates nothing past its start. A task sorts its less
+*           part in a new thread and its more part itself. A descending sort swaps the comparator's arguments, so equal
+*           elements still keep their order.
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "cmpsort.h"
+#include "quicksort.h"
+#include "memtrack.h"
+#include "timing.h"
+
+#define COMPARE_INSERTION_MAX 16        // at most this many elements, insertion sort
+#define COMPARE_NINTHER_MIN 40          // smallest part that takes the ninther pivot
+
+/**
+ * @brief The comparator of a sort and the direction it is applied in.
+ */
+typedef struct {
+    SortCompare compare;
+    void *context;
+    size_t elem_size;
+    int descending;
+} CompareOrder;
+
+/**
+ * @brief Arguments of one comparator sorting task, like ThreadArgs.
+ *
+ * `scratch` and `classes` are the task's slices of the shared buffers, at
+ * the same positions as `data`.
+ */
+typedef struct {
+    unsigned char *data;
+    unsigned char *scratch;
+    unsigned char *classes;
+    size_t size;
+    size_t cutoff;
+    size_t threads;
+    const CompareOrder *order;
+    SortStats stats;
+} CompareTask;
+
+static inline int compare_elements(const CompareOrder *order, const void *a, const void *b) {
+    return order->descending ? order->compare(b, a, order->context) : order->compare(a, b, order->context);
+}
+
+static const unsigned char *median_of_three(const CompareOrder *order, const unsigned char *a, const unsigned char *b,
+                                            const unsigned char *c) {
+    if (compare_elements(order, a, b) > 0) {
+        const unsigned char *t = a;
+        a = b;
+        b = t;
+    }
+    if (compare_elements(order, b, c) > 0) b = c;
+    return compare_elements(order, a, b) > 0 ? a : b;
+}
+
+/**
+ * @brief Picks the pivot like choose_pivot(): the median of three, or the ninther from COMPARE_NINTHER_MIN elements.
+ *
+ * @return A pointer to the pivot element inside data.
+ */
+static const unsigned char *choose_element(const CompareOrder *order, const unsigned char *data, size_t size) {
+    size_t w = order->elem_size;
+    if (size < COMPARE_NINTHER_MIN)
+        return median_of_three(order, data, data + size / 2 * w, data + (size - 1) * w);
+    size_t stride = size / 9, hash = size;
+    const unsigned char *samples[9];
+    for (size_t i = 0; i < 9; i++) {
+        hash = hash * 6364136223846793005u + 1442695040888963407u;
+        samples[i] = data + (i * stride + (hash >> 16) % stride) * w;
+    }
+    return median_of_three(order, median_of_three(order, samples[0], samples[1], samples[2]),
+                           median_of_three(order, samples[3], samples[4], samples[5]),
+                           median_of_three(order, samples[6], samples[7], samples[8]));
+}
+
+/**
+ * @brief Stable insertion sort; slot is scratch space for one element.
+ */
+static void insertion_sort(unsigned char *data, size_t size, unsigned char *slot, const CompareOrder *order) {
+    size_t w = order->elem_size;
+    for (size_t i = 1; i < size; i++) {
+        size_t j = i;
+        while (j > 0 && compare_elements(order, data + (j - 1) * w, data + i * w) > 0) j--;
+        if (j == i) continue;
+        memcpy(slot, data + i * w, w);
+        memmove(data + (j + 1) * w, data + j * w, (i - j) * w);
+        memcpy(data + j * w, slot, w);
+    }
+}
+
+/**
+ * @brief Three-way partitions the elements of a task in place, keeping the order within each part.
+ *
+ * Every element is compared with the pivot once; its class is kept so the
+ * scatter into scratch does not compare again.
+ *
+ * @param[out] less_size  Elements before the pivot, moved to the front.
+ * @param[out] equal_size Elements equal to the pivot, moved next.
+ */
+static void partition_elements(unsigned char *data, unsigned char *scratch, unsigned char *classes, size_t size,
+                               const CompareOrder *order, size_t *less_size, size_t *equal_size) {
+    size_t w = order->elem_size, counts[3] = {0, 0, 0};
+    const unsigned char *pivot = choose_element(order, data, size);
+    for (size_t i = 0; i < size; i++) {
+        int c = compare_elements(order, data + i * w, pivot);
+        classes[i] = c < 0 ? 0 : c == 0 ? 1 : 2;
+        counts[classes[i]]++;
+    }
+    *less_size = counts[0];
+    *equal_size = counts[1];
+    if (counts[1] == size) return;
+    size_t next[3] = {0, counts[0], counts[0] + counts[1]};
+    for (size_t i = 0; i < size; i++) memcpy(scratch + next[classes[i]]++ * w, data + i * w, w);
+    memcpy(data, scratch, size * w);
+}
+
+/**
+ * @brief Sorts the elements of a task serially, recursing into the smaller part and looping on the larger.
+ */
+static void sort_serial(unsigned char *data, unsigned char *scratch, unsigned char *classes, size_t size,
+                        const CompareOrder *order, SortStats *stats) {
+    size_t w = order->elem_size;
+    while (size > 1) {
+        if (size <= COMPARE_INSERTION_MAX) {
+            insertion_sort(data, size, scratch, order);
+            return;
+        }
+        size_t less_size, equal_size;
+        partition_elements(data, scratch, classes, size, order, &less_size, &equal_size);
+        stats->elements_partitioned += size;
+        size_t skip = less_size + equal_size, more_size = size - skip;
+        if (less_size < more_size) {
+            sort_serial(data, scratch, classes, less_size, order, stats);
+            data += skip * w;
+            scratch += skip * w;
+            classes += skip;
+            size = more_size;
+        } else {
+            sort_serial(data + skip * w, scratch + skip * w, classes + skip, more_size, order, stats);
+            size = less_size;
+        }
+    }
+}
+
+/**
+ * @brief Thread body: sorts the elements of a CompareTask, filling in its stats.
+ */
+static void *compare_task(void *arg) {
+    CompareTask *task = arg;
+    const CompareOrder *order = task->order;
+    size_t size = task->size, w = order->elem_size;
+    SortStats *stats = &task->stats;
+    memset(stats, 0, sizeof(*stats));
+    stats->tasks = 1;
+    if (size < task->cutoff || task->threads == 1 || size <= COMPARE_INSERTION_MAX) {
+        sort_serial(task->data, task->scratch, task->classes, size, order, stats);
+        return NULL;
+    }
+
+    size_t less_size, equal_size;
+    partition_elements(task->data, task->scratch, task->classes, size, order, &less_size, &equal_size);
+    stats->elements_partitioned += size;
+    size_t skip = less_size + equal_size, more_size = size - skip;
+
+    CompareTask less = {task->data, task->scratch, task->classes, less_size, task->cutoff,
+                        sort_budget_share(task->threads, less_size, size), order, {0}};
+    CompareTask more = {task->data + skip * w, task->scratch + skip * w, task->classes + skip, more_size, task->cutoff,
+                        sort_budget_share(task->threads, more_size, size), order, {0}};
+    pthread_t less_thread;
+    int less_spawned = 0;
+    // fall back to sorting in this thread when no more threads can be created
+    if (less_size > 1) {
+        less_spawned = pthread_create(&less_thread, NULL, compare_task, &less) == 0;
+        if (!less_spawned) sort_serial(less.data, less.scratch, less.classes, less_size, order, stats);
+    }
+    stats->threads_spawned += (size_t)less_spawned;
+    stats->inline_sorts += (size_t)(less_size > 1 && !less_spawned);
+
+    // this thread sorts the more part while the less part runs
+    if (more_size > 1) {
+        compare_task(&more);
+        sort_stats_add(stats, &more.stats);
+    }
+
+    double idle_begin = timing_wall();
+    if (less_spawned) pthread_join(less_thread, NULL);
+    stats->idle_seconds += timing_wall() - idle_begin;
+    if (less_spawned) sort_stats_add(stats, &less.stats);
+    return NULL;
+}
+
+/**
+ * @brief Sorts size elements of elem_size bytes in place, in the order of compare (reversed if descending).
+ *
+ * Elements that compare equal keep their order in both directions.
+ *
+ * @param cutoff  Part size below which no more threads are started.
+ * @param threads Thread budget; 0 is unlimited and 1 sorts serially.
+ * @param stats   Receives the counters of the sort.
+ * @return 0 on success, or -1 if memory allocation fails; base is then unchanged.
+ */
+int compare_sort(void *base, size_t size, size_t elem_size, SortCompare compare, void *context, int descending,
+                 size_t cutoff, size_t threads, SortStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (size < 2) return 0;
+    if (size > SIZE_MAX / elem_size) return -1;
+    unsigned char *scratch = memtrack_malloc(size * elem_size);
+    unsigned char *classes = memtrack_malloc(size);
+    if (!scratch || !classes) {
+        memtrack_free(scratch, size * elem_size);
+        memtrack_free(classes, size);
+        return -1;
+    }
+    CompareOrder order = {compare, context, elem_size, descending};
+    CompareTask root = {base, scratch, classes, size, cutoff, threads, &order, {0}};
+    compare_task(&root);
+    *stats = root.stats;
+    stats->bytes_allocated += size * (elem_size + 1);
+    memtrack_free(scratch, size * elem_size);
+    memtrack_free(classes, size);
+    return 0;
+}
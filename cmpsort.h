@@ -0,0 +1,19 @@
+/*
+* @author   Jatin Jain
+* @file     cmpsort.h
+* @desc     parallel stable quicksort of fixed-size elements under a caller's comparator, the engine behind
+*           sorter_sort_compare().
+* @date     17 october 2026
+*/
+
+#ifndef CMPSORT_H
+#define CMPSORT_H
+
+#include <stddef.h>
+
+#include "threadedsort.h"
+
+int compare_sort(void *base, size_t size, size_t elem_size, SortCompare compare, void *context, int descending,
+                 size_t cutoff, size_t threads, SortStats *stats);
+
+#endif
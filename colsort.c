@@ -0,0 +1,119 @@
+/*
+* @author   Jatin Jain
+* @file     colsort.c
+* @desc     multi-column argsort: a multikey quicksort whose keys are the columns of a table instead of the chunks of a
+*           string. Every row index carries the order-preserving key of its value in the current column; the rows are
+*           three-way partitioned on it, the less and more parts are sorted on the same column and the equal part moves
+*           on to the next column, so later columns are only read for the rows that tie on all earlier ones. Past the last
+*           column the key is the row's position, which makes the sort stable. The partitioning
+*           and the task tree are those of multikey_sort(), with one level per column.
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "colsort.h"
+#include "multikey.h"
+#include "memtrack.h"
+#include "keys.h"
+
+/**
+ * @brief The columns to sort by, first column first.
+ */
+typedef struct {
+    const SortKeyType *key_types;
+    const void *const *columns;
+    const SortOrder *orders;
+    size_t column_count;
+} Table;
+
+/**
+ * @brief The key of a row in a column: its encoded value, complemented if the column is descending.
+ *
+ * NaNs map to the largest key, so they go last in both directions. The
+ * column after the last one is the row position itself.
+ */
+static uint64_t row_key(const Table *table, size_t column, size_t row) {
+    if (column == table->column_count) return row;
+    const void *values = table->columns[column];
+    uint64_t key = 0;
+    switch (table->key_types[column]) {
+    case SORT_KEY_INT32: key = encode_int32(((const int32_t *)values)[row]); break;
+    case SORT_KEY_UINT32: key = encode_uint32(((const uint32_t *)values)[row]); break;
+    case SORT_KEY_INT64: key = encode_int64(((const int64_t *)values)[row]); break;
+    case SORT_KEY_UINT64: key = encode_uint64(((const uint64_t *)values)[row]); break;
+    case SORT_KEY_FLOAT: {
+        float v = ((const float *)values)[row];
+        if (isnan(v)) return UINT64_MAX;
+        key = encode_float(v);
+        break;
+    }
+    case SORT_KEY_DOUBLE: {
+        double v = ((const double *)values)[row];
+        if (isnan(v)) return UINT64_MAX;
+        key = encode_double(v);
+        break;
+    }
+    }
+    return table->orders[column] == SORT_DESCENDING ? ~key : key;
+}
+
+/**
+ * @brief Caches the key of each row in column level of the Table in context.
+ */
+static void load_keys(MultikeyItem *items, size_t size, size_t level, const void *context) {
+    for (size_t i = 0; i < size; i++) items[i].key = row_key(context, level, items[i].ref);
+}
+
+/**
+ * @brief Compares two rows that are equal before column level; never 0 for distinct rows.
+ */
+static int compare_rows(const MultikeyItem *a, const MultikeyItem *b, size_t level, const void *context) {
+    const Table *table = context;
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    for (size_t c = level + 1; c <= table->column_count; c++) {
+        uint64_t ka = row_key(table, c, a->ref), kb = row_key(table, c, b->ref);
+        if (ka != kb) return ka < kb ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Nonzero past the last column, where the keys are the distinct row positions.
+ */
+static int last_column(uint64_t key, size_t level, const void *context) {
+    (void)key;
+    return level == ((const Table *)context)->column_count;
+}
+
+/**
+ * @brief Writes the order of the rows of a table sorted by its columns, first column first, to indices.
+ *
+ * @param key_types    Type of each column.
+ * @param columns      column_count arrays of size values each; they are only read.
+ * @param orders       Direction of each column.
+ * @param cutoff       Part size below which no more threads are started.
+ * @param threads      Thread budget; 0 is unlimited and 1 sorts serially.
+ * @param[out] indices size row positions; rows that tie on every column are listed in position order.
+ * @param stats        Receives the counters of the sort.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int column_sort(const SortKeyType *key_types, const void *const *columns, const SortOrder *orders, size_t column_count,
+                size_t size, size_t cutoff, size_t threads, size_t *indices, SortStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (size == 0) return 0;
+    MultikeyItem *items = memtrack_malloc(size * sizeof(MultikeyItem));
+    if (!items) return -1;
+    Table table = {key_types, columns, orders, column_count};
+    for (size_t i = 0; i < size; i++) items[i].ref = i;
+    MultikeyOps ops = {load_keys, compare_rows, last_column, &table};
+    multikey_sort(items, size, cutoff, threads, &ops, stats);
+    stats->bytes_allocated += size * sizeof(MultikeyItem);
+    for (size_t i = 0; i < size; i++) indices[i] = items[i].ref;
+    memtrack_free(items, size * sizeof(MultikeyItem));
+    return 0;
+}
@@ -0,0 +1,18 @@
+/*
+* @author   Jatin Jain
+* @file     colsort.h
+* @desc     parallel multi-column (lexicographic) argsort of a columnar table, the engine behind sorter_argsort_columns().
+* @date     17 october 2026
+*/
+
+#ifndef COLSORT_H
+#define COLSORT_H
+
+#include <stddef.h>
+
+#include "threadedsort.h"
+
+int column_sort(const SortKeyType *key_types, const void *const *columns, const SortOrder *orders, size_t column_count,
+                size_t size, size_t cutoff, size_t threads, size_t *indices, SortStats *stats);
+
+#endif
@@ -0,0 +1,540 @@
+/*
+* @author   Jatin Jain
+* @file     extsort.c
+* @desc     external sort for inputs larger than memory. The input is read in chunks sized to the memory budget, each chunk is
+*           sorted in place with the parallel radix sort and spilled as a compressed run (runcodec.c) to a temp directory, and
+*           the runs are merged with kmerge_streams().
+*           The next chunk is parsed by a loader thread while the current one is sorted, and the previous sorted run is
+*           written in the background through aio.c while the current one is sorted.
+* @date     17 october 2026
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "threadedsort.h"
+#include "extsort.h"
+#include "kmerge.h"
+#include "textio.h"
+#include "aio.h"
+#include "runcodec.h"
+
+#define MIN_RUN_BUFFER   (64 << 10)     // smallest read buffer per run while merging
+#define MAX_FAN_IN       512            // runs merged at once, also bounded by the open file limit
+#define RESERVED_FDS     16             // descriptors kept free for stdio, input, output and the I/O queues
+#define CHUNK_FACTOR     5              // two chunk buffers, the run being written, keys and scratch of the radix sort
+#define SPILL_PIECES     8              // writes in flight for one spilled run
+
+/**
+ * @brief Paths of the runs spilled so far.
+ */
+typedef struct {
+    char **paths;
+    size_t count;
+    size_t capacity;
+} RunList;
+
+/**
+ * @brief A sorted run being written in the background. The encoded run is
+ * written in SPILL_PIECES writes and freed once they complete.
+ */
+typedef struct {
+    AioQueue *queue;
+    AioRequest reqs[SPILL_PIECES];
+    size_t pieces;
+    int fd;
+    unsigned char *encoded;
+} Spill;
+
+/**
+ * @brief A compressed run file read through the read-ahead reader and decoded
+ * one codec block at a time, handed out as a KMergeFill.
+ */
+typedef struct {
+    int fd;
+    AioReader reader;
+    const char *block;
+    size_t len;
+    size_t pos;
+    int values[RUN_BLOCK];
+    size_t count;
+    size_t next;
+    unsigned char staged[RUN_BLOCK_MAX_BYTES];
+} RunStream;
+
+/**
+ * @brief Encodes merged ints into a compressed run file, a codec block at a time.
+ */
+typedef struct {
+    AioWriter aio;
+    int values[RUN_BLOCK];
+    size_t count;
+} RunWriter;
+
+/**
+ * @brief Work handed to the loader thread: fill buf with up to capacity integers.
+ */
+typedef struct {
+    TextReader *reader;
+    int *buf;
+    size_t capacity;
+    size_t count;
+    int status;
+} LoadJob;
+
+/**
+ * @brief Fills default settings: 256 MiB budget, $TMPDIR or /tmp.
+ *
+ * @param[out] config The settings to initialise.
+ */
+void extsort_config_init(ExtSortConfig *config) {
+    const char *tmp = getenv("TMPDIR");
+    config->memory_budget = (size_t)256 << 20;
+    config->tmp_dir = (tmp && *tmp) ? tmp : "/tmp";
+}
+
+/**
+ * @brief Copies up to n bytes of the run into dst, moving across read-ahead blocks.
+ *
+ * @return Bytes copied, less than n only at end of file, or -1 on a read error.
+ */
+static ssize_t run_stream_bytes(RunStream *run, unsigned char *dst, size_t n) {
+    size_t copied = 0;
+    while (copied < n) {
+        if (run->pos == run->len) {
+            if (aio_reader_next(&run->reader, &run->block, &run->len) < 0) return -1;
+            run->pos = 0;
+            if (run->len == 0) break;
+        }
+        size_t bytes = n - copied;
+        if (bytes > run->len - run->pos) bytes = run->len - run->pos;
+        memcpy(dst + copied, run->block + run->pos, bytes);
+        run->pos += bytes;
+        copied += bytes;
+    }
+    return (ssize_t)copied;
+}
+
+/**
+ * @brief Decodes the next codec block of the run into run->values.
+ *
+ * Blocks that lie inside one read-ahead block are decoded in place, the
+ * others are first gathered into run->staged.
+ *
+ * @return 0 on success (count 0 at end of file), or -1 on a read error or a truncated or corrupt run.
+ */
+static int run_stream_decode(RunStream *run) {
+    run->count = run->next = 0;
+    if (run->len - run->pos >= RUN_BLOCK_HEADER) {
+        const unsigned char *in = (const unsigned char *)run->block + run->pos;
+        if (!run_block_valid(in)) {
+            fprintf(stderr, "Corrupt run file\n");
+            return -1;
+        }
+        size_t size = run_block_size(in);
+        if (run->len - run->pos >= size) {
+            run->count = run_decode_block(in, run->values);
+            run->pos += size;
+            return 0;
+        }
+    }
+
+    ssize_t got = run_stream_bytes(run, run->staged, RUN_BLOCK_HEADER);
+    if (got <= 0) return (int)got;
+    if (got == RUN_BLOCK_HEADER && !run_block_valid(run->staged)) {
+        fprintf(stderr, "Corrupt run file\n");
+        return -1;
+    }
+    size_t size = run_block_size(run->staged);
+    if (got < RUN_BLOCK_HEADER
+        || run_stream_bytes(run, run->staged + RUN_BLOCK_HEADER, size - RUN_BLOCK_HEADER) != (ssize_t)(size - RUN_BLOCK_HEADER)) {
+        fprintf(stderr, "Truncated run file\n");
+        return -1;
+    }
+    run->count = run_decode_block(run->staged, run->values);
+    return 0;
+}
+
+/**
+ * @brief KMergeFill over a compressed run file.
+ *
+ * @return 0 on success, or -1 on a read error.
+ */
+static int run_stream_read(void *ctx, int *buf, size_t capacity, size_t *len) {
+    RunStream *run = (RunStream *)ctx;
+    size_t n = 0;
+    while (n < capacity) {
+        if (run->next == run->count) {
+            if (run_stream_decode(run) < 0) return -1;
+            if (run->count == 0) break;
+        }
+        size_t take = run->count - run->next;
+        if (take > capacity - n) take = capacity - n;
+        memcpy(buf + n, run->values + run->next, take * sizeof(int));
+        run->next += take;
+        n += take;
+    }
+    *len = n;
+    return 0;
+}
+
+/**
+ * @brief KMergeFlush into a compressed run file: full codec blocks are encoded
+ * and handed to the double-buffered writer.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+static int run_file_write(void *ctx, const int *buf, size_t len) {
+    RunWriter *w = (RunWriter *)ctx;
+    unsigned char block[RUN_BLOCK_MAX_BYTES];
+    for (size_t i = 0; i < len; i++) {
+        w->values[w->count++] = buf[i];
+        if (w->count == RUN_BLOCK) {
+            size_t bytes = run_encode_block(w->values, RUN_BLOCK, block);
+            w->count = 0;
+            if (aio_writer_write(&w->aio, block, bytes) < 0) return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Encodes the last partial block and waits for the run to be written.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+static int run_writer_close(RunWriter *w) {
+    unsigned char block[RUN_BLOCK_MAX_BYTES];
+    int status = 0;
+    if (w->count) status = aio_writer_write(&w->aio, block, run_encode_block(w->values, w->count, block));
+    if (aio_writer_close(&w->aio) < 0) status = -1;
+    return status;
+}
+
+/**
+ * @brief Creates a new, empty run file in the temp directory and records its path.
+ *
+ * @return The open file descriptor, or -1 if it cannot be created.
+ */
+static int run_list_create(RunList *runs, const char *tmp_dir) {
+    if (runs->count == runs->capacity) {
+        size_t capacity = runs->capacity ? runs->capacity * 2 : 16;
+        char **paths = realloc(runs->paths, capacity * sizeof(char *));
+        if (!paths) {
+            perror("Memory allocation failed");
+            return -1;
+        }
+        runs->paths = paths;
+        runs->capacity = capacity;
+    }
+
+    size_t length = strlen(tmp_dir) + sizeof("/extsort-XXXXXX");
+    char *path = malloc(length);
+    if (!path) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+    snprintf(path, length, "%s/extsort-XXXXXX", tmp_dir);
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("Error creating run file");
+        free(path);
+        return -1;
+    }
+    runs->paths[runs->count++] = path;
+    return fd;
+}
+
+/**
+ * @brief Deletes the run files [from, to) and frees their paths.
+ */
+static void run_list_remove(RunList *runs, size_t from, size_t to) {
+    for (size_t i = from; i < to; i++) {
+        if (!runs->paths[i]) continue;
+        unlink(runs->paths[i]);
+        free(runs->paths[i]);
+        runs->paths[i] = NULL;
+    }
+}
+
+/**
+ * @brief Merges the runs [from, to) into a sink.
+ *
+ * @param[in] runs        The spilled runs.
+ * @param[in] from        Index of the first run to merge.
+ * @param[in] to          One past the last run to merge.
+ * @param[in] buffer_ints Number of ints buffered per input run.
+ * @param[in] sink        Receives the merged values.
+ * @return 0 on success, or -1 on an I/O or allocation error.
+ */
+static int merge_runs(RunList *runs, size_t from, size_t to, size_t buffer_ints, const KMergeSink *sink) {
+    size_t k = to - from;
+    KMergeSource *sources = calloc(k, sizeof(KMergeSource));
+    RunStream *streams = calloc(k, sizeof(RunStream));
+    AioQueue *queue = NULL;
+    size_t opened = 0;
+    int status = -1;
+
+    if (!sources || !streams) {
+        perror("Memory allocation failed");
+        goto done;
+    }
+    // one queue for all the readers, so a run costs one descriptor (its file) and no I/O thread of its own
+    queue = aio_queue_create((unsigned)(k * AIO_READ_AHEAD));
+    if (!queue) goto done;
+    for (; opened < k; opened++) {
+        RunStream *run = &streams[opened];
+        run->fd = open(runs->paths[from + opened], O_RDONLY);
+        if (run->fd < 0) {
+            perror("Error opening run");
+            goto done;
+        }
+        if (aio_reader_open(&run->reader, queue, run->fd, buffer_ints * sizeof(int)) < 0) {
+            close(run->fd);
+            goto done;
+        }
+        sources[opened].fill = run_stream_read;
+        sources[opened].ctx = run;
+    }
+    status = kmerge_streams(sources, k, buffer_ints, sink);
+
+done:
+    for (size_t i = 0; i < opened; i++) {
+        aio_reader_close(&streams[i].reader);
+        close(streams[i].fd);
+    }
+    aio_queue_destroy(queue);
+    free(sources);
+    free(streams);
+    return status;
+}
+
+/**
+ * @brief Most runs that can be open at once: the open file limit less RESERVED_FDS, at most MAX_FAN_IN.
+ */
+static size_t open_runs_limit(void) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY) return MAX_FAN_IN;
+    if (limit.rlim_cur <= RESERVED_FDS + 2) return 2;
+    return limit.rlim_cur - RESERVED_FDS < MAX_FAN_IN ? (size_t)(limit.rlim_cur - RESERVED_FDS) : MAX_FAN_IN;
+}
+
+/**
+ * @brief Size of each merge buffer when merging k runs: the budget split over
+ * the k inputs and the output, each with a merge buffer and its read-ahead or
+ * write-behind blocks, at most 1 MiB each.
+ */
+static size_t merge_buffer_ints(const ExtSortConfig *config, size_t k) {
+    size_t ints = config->memory_budget / ((k + 1) * (AIO_READ_AHEAD + 1) * sizeof(int));
+    if (ints < 1024) ints = 1024;
+    if (ints > (1 << 20) / sizeof(int)) ints = (1 << 20) / sizeof(int);
+    return ints;
+}
+
+/**
+ * @brief Loader thread body: parses up to job->capacity integers into job->buf.
+ */
+static void *load_chunk(void *arg) {
+    LoadJob *job = (LoadJob *)arg;
+    job->status = text_reader_read(job->reader, job->buf, job->capacity, &job->count);
+    return NULL;
+}
+
+/**
+ * @brief Encodes a sorted chunk as a compressed run and starts writing it in the background.
+ *
+ * The chunk can be reused as soon as this returns.
+ *
+ * @return 0 on success, or -1 if encoding or a write cannot be started; the
+ *         spill owns fd in both cases and spill_finish() must be called.
+ */
+static int spill_start(Spill *spill, int fd, const int *sorted, size_t size) {
+    spill->fd = fd;
+    spill->pieces = 0;
+    spill->encoded = malloc(run_encode_bound(size));
+    if (!spill->encoded) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+    size_t bytes = run_encode(sorted, size, spill->encoded);
+
+    size_t piece = (bytes + SPILL_PIECES - 1) / SPILL_PIECES;
+    for (size_t offset = 0; offset < bytes; offset += piece) {
+        size_t len = bytes - offset < piece ? bytes - offset : piece;
+        AioRequest req = {fd, 1, (char *)spill->encoded + offset, len, (off_t)offset, 0, 0, NULL};
+        spill->reqs[spill->pieces] = req;
+        if (aio_submit(spill->queue, &spill->reqs[spill->pieces]) < 0) return -1;
+        spill->pieces++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Waits for a spilled run to be written, then closes it and frees the encoded run.
+ *
+ * @return 0 if the whole run was written, or -1 on a write error.
+ */
+static int spill_finish(Spill *spill) {
+    int status = 0;
+    for (size_t i = 0; i < spill->pieces; i++) {
+        if (aio_wait(spill->queue, &spill->reqs[i]) != (ssize_t)spill->reqs[i].len && status == 0) {
+            fprintf(stderr, "Error writing run\n");
+            status = -1;
+        }
+    }
+    if (spill->fd >= 0 && close(spill->fd) != 0 && status == 0) {
+        perror("Error writing run");
+        status = -1;
+    }
+    free(spill->encoded);
+    spill->pieces = 0;
+    spill->fd = -1;
+    spill->encoded = NULL;
+    return status;
+}
+
+/**
+ * @brief Sorts a text file of integers using bounded memory.
+ *
+ * Run generation parses the input in chunks of memory_budget / (5 * sizeof(int))
+ * integers. While one chunk is being sorted in place with the radix sort a
+ * loader thread parses the next one into the second buffer and the previous
+ * sorted chunk is written out as a compressed run in the background. The two
+ * chunk buffers, the radix sort's key and scratch buffers and the encoded run
+ * (at most 1/64 larger than a chunk) are all the large allocations, so the
+ * peak stays within the budget plus the fixed I/O buffers. If the whole input
+ * fits in one chunk it is written straight to the output. Otherwise the runs
+ * are merged with a loser tree, in several passes when there are more runs
+ * than can be merged at once; the run files are read ahead and the merged
+ * output written behind while the merge runs.
+ *
+ * @param[in] input_path  File of whitespace separated integers.
+ * @param[in] output_path File that receives the sorted integers one per line, or NULL for stdout.
+ * @param[in] config      Memory budget and temp directory.
+ * @return 0 on success, or -1 on failure. Spilled runs are removed in both cases.
+ */
+int external_sort(const char *input_path, const char *output_path, const ExtSortConfig *config) {
+    size_t chunk_ints = config->memory_budget / (CHUNK_FACTOR * sizeof(int));
+    if (chunk_ints < 1024) chunk_ints = 1024;
+
+    TextReader reader;
+    TextWriter writer;
+    RunList runs = {NULL, 0, 0};
+    Spill spill = {NULL, {{0}}, 0, -1, NULL};
+    int *chunks[2] = {NULL, NULL};
+    Sorter *sorter = NULL;
+    int status = -1;
+
+    if (text_reader_open(&reader, input_path) < 0) return -1;
+    if (text_writer_open(&writer, output_path) < 0) {
+        text_reader_close(&reader);
+        return -1;
+    }
+    chunks[0] = malloc(chunk_ints * sizeof(int));
+    chunks[1] = malloc(chunk_ints * sizeof(int));
+    sorter = sorter_create();
+    if (!chunks[0] || !chunks[1] || !sorter) {
+        perror("Memory allocation failed");
+        goto done;
+    }
+    spill.queue = aio_queue_create(SPILL_PIECES);
+    if (!spill.queue) goto done;
+
+    // run generation: parse chunk i+1 while chunk i is sorted and spilled
+    LoadJob job = {&reader, chunks[0], chunk_ints, 0, 0};
+    load_chunk(&job);
+    int current = 0;
+    while (job.status == 0 && job.count > 0) {
+        size_t count = job.count;
+        int at_end = count < chunk_ints;
+
+        pthread_t loader;
+        int loading = 0;
+        if (!at_end) {
+            job.buf = chunks[1 - current];
+            loading = pthread_create(&loader, NULL, load_chunk, &job) == 0;
+            if (!loading) load_chunk(&job);
+        }
+
+        // the radix sort needs a key and a scratch buffer, where the quicksort engines allocate three buffers per level
+        int *sorted = chunks[current];
+        int failed = sorter_sort_int32(sorter, sorted, count) < 0;
+        if (failed) fprintf(stderr, "Failed to sort chunk\n");
+
+        // the previous run was being written while this chunk was sorted
+        if (spill_finish(&spill) < 0) failed = 1;
+
+        if (!failed && at_end && runs.count == 0) {
+            // everything fit in memory, no need to spill
+            failed = text_writer_write(&writer, sorted, count) < 0;
+        } else if (!failed) {
+            int fd = run_list_create(&runs, config->tmp_dir);
+            failed = fd < 0 || spill_start(&spill, fd, sorted, count) < 0;
+        }
+
+        if (loading) pthread_join(loader, NULL);
+        if (failed) goto done;
+        if (at_end) {
+            job.count = 0;
+            break;
+        }
+        current = 1 - current;
+    }
+    if (spill_finish(&spill) < 0 || job.status < 0) goto done;
+    free(chunks[0]);
+    free(chunks[1]);
+    chunks[0] = chunks[1] = NULL;
+
+    // merge passes: runs beyond the fan-in are first merged into longer runs
+    size_t fan_in = config->memory_budget / MIN_RUN_BUFFER;
+    if (fan_in > open_runs_limit()) fan_in = open_runs_limit();
+    if (fan_in < 2) fan_in = 2;
+    size_t first = 0;
+    while (runs.count - first > fan_in) {
+        size_t to = first + fan_in;
+        size_t buffer_ints = merge_buffer_ints(config, fan_in);
+        int fd = run_list_create(&runs, config->tmp_dir);
+        if (fd < 0) goto done;
+        RunWriter out;
+        out.count = 0;
+        if (aio_writer_open(&out.aio, fd, buffer_ints * sizeof(int)) < 0) {
+            close(fd);
+            goto done;
+        }
+        KMergeSink sink = {run_file_write, &out};
+        int failed = merge_runs(&runs, first, to, buffer_ints, &sink) < 0;
+        if (run_writer_close(&out) < 0) failed = 1;
+        if (close(fd) != 0) failed = 1;
+        if (failed) goto done;
+        run_list_remove(&runs, first, to);
+        first = to;
+    }
+    if (runs.count > first) {
+        KMergeSink sink = {text_writer_write, &writer};
+        if (merge_runs(&runs, first, runs.count, merge_buffer_ints(config, runs.count - first), &sink) < 0) goto done;
+    }
+    status = 0;
+
+done:
+    if (spill.queue) {
+        spill_finish(&spill);
+        aio_queue_destroy(spill.queue);
+    }
+    run_list_remove(&runs, 0, runs.count);
+    free(runs.paths);
+    free(chunks[0]);
+    free(chunks[1]);
+    sorter_destroy(sorter);
+    text_reader_close(&reader);
+    if (text_writer_close(&writer) < 0) status = -1;
+    return status;
+}
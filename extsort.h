@@ -0,0 +1,30 @@
+/*
+* @author   Jatin Jain
+* @file     extsort.h
+* @desc     external (out-of-core) sort of a file of integers: sorted runs are spilled to a temp directory and k-way merged.
+* @date     17 october 2026
+*/
+
+#ifndef EXTSORT_H
+#define EXTSORT_H
+
+#include <stddef.h>
+
+/**
+ * @brief Settings for external_sort().
+ *
+ * `memory_budget` bounds the memory used for run generation (two chunk
+ * buffers, the key and scratch buffers of the radix sort and the run being
+ * written) and for the merge buffers; the text reader and writer add a few
+ * MiB of fixed buffers on top. `tmp_dir` is where the sorted runs are spilled.
+ */
+typedef struct {
+    size_t memory_budget;
+    const char *tmp_dir;
+} ExtSortConfig;
+
+void extsort_config_init(ExtSortConfig *config);
+
+int external_sort(const char *input_path, const char *output_path, const ExtSortConfig *config);
+
+#endif
@@ -0,0 +1,155 @@
+/*
+* @author   Jatin Jain
+* @file     gen.c
+* @desc     generators for the benchmark inputs: random, presorted and duplicate-heavy patterns that stress different parts of
+*           the engines (pivot choice on sorted data, the equal partition on few unique values, and so on).
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "gen.h"
+
+#define ZIPF_UNIVERSE 65536             // distinct values drawn by the Zipf generator
+#define ZIPF_EXPONENT 1.1
+#define FEW_UNIQUE    16                // distinct values of the few_unique distribution
+
+static const char *const names[DIST_COUNT] = {
+    "uniform", "sorted", "reverse", "organ_pipe", "sawtooth",
+    "few_unique", "all_equal", "zipf", "gaussian"
+};
+
+/**
+ * @brief splitmix64 step: a fast, well mixed 64-bit generator for reproducible inputs.
+ */
+static uint64_t next_random(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Uniform double in (0, 1).
+ */
+static double next_unit(uint64_t *state) {
+    return ((double)(next_random(state) >> 11) + 0.5) / 9007199254740992.0;
+}
+
+/**
+ * @brief Name of a distribution as used on the command line.
+ */
+const char *gen_name(Distribution dist) {
+    return dist < DIST_COUNT ? names[dist] : "unknown";
+}
+
+/**
+ * @brief Finds a distribution by name.
+ *
+ * @return 0 on success, or -1 if the name is unknown.
+ */
+int gen_lookup(const char *name, Distribution *dist) {
+    for (int i = 0; i < DIST_COUNT; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *dist = (Distribution)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Draws Zipf distributed ranks by binary search in the cumulative distribution.
+ *
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+static int fill_zipf(int *data, size_t size, uint64_t *state) {
+    double *cdf = malloc(ZIPF_UNIVERSE * sizeof(double));
+    if (!cdf) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+    double sum = 0.0;
+    for (size_t k = 0; k < ZIPF_UNIVERSE; k++) {
+        sum += 1.0 / pow((double)(k + 1), ZIPF_EXPONENT);
+        cdf[k] = sum;
+    }
+    for (size_t i = 0; i < size; i++) {
+        double u = next_unit(state) * sum;
+        size_t lo = 0, hi = ZIPF_UNIVERSE - 1;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (cdf[mid] < u) lo = mid + 1;
+            else hi = mid;
+        }
+        data[i] = (int)lo;
+    }
+    free(cdf);
+    return 0;
+}
+
+/**
+ * @brief Fills data with size values of the given distribution.
+ *
+ * - uniform: random over the whole int range.
+ * - sorted / reverse: distinct values in ascending / descending order.
+ * - organ_pipe: ascending to the middle, then descending.
+ * - sawtooth: ascending ramps of length sqrt(size).
+ * - few_unique: random among 16 values.
+ * - all_equal: one value.
+ * - zipf: ranks 0..65535 with Zipf(1.1) frequencies, so a few values dominate.
+ * - gaussian: normal with mean 0 and standard deviation 1e6.
+ *
+ * @param[in]  dist The distribution.
+ * @param[out] data Receives the values.
+ * @param[in]  size Number of values.
+ * @param[in]  seed Seed of the random distributions; the same seed gives the same input.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int gen_fill(Distribution dist, int *data, size_t size, uint64_t seed) {
+    uint64_t state = seed;
+    long long half = (long long)(size / 2);
+    size_t period = 1;
+    while (period * period < size) period++;
+
+    switch (dist) {
+    case DIST_UNIFORM:
+        for (size_t i = 0; i < size; i++) data[i] = (int)(uint32_t)next_random(&state);
+        break;
+    case DIST_SORTED:
+        for (size_t i = 0; i < size; i++) data[i] = (int)((long long)i - half);
+        break;
+    case DIST_REVERSE:
+        for (size_t i = 0; i < size; i++) data[i] = (int)(half - (long long)i);
+        break;
+    case DIST_ORGAN_PIPE:
+        for (size_t i = 0; i < size; i++) data[i] = (int)(i < size / 2 ? i : size - 1 - i);
+        break;
+    case DIST_SAWTOOTH:
+        for (size_t i = 0; i < size; i++) data[i] = (int)(i % period);
+        break;
+    case DIST_FEW_UNIQUE:
+        for (size_t i = 0; i < size; i++) data[i] = (int)(next_random(&state) % FEW_UNIQUE);
+        break;
+    case DIST_ALL_EQUAL:
+        for (size_t i = 0; i < size; i++) data[i] = 42;
+        break;
+    case DIST_ZIPF:
+        return fill_zipf(data, size, &state);
+    case DIST_GAUSSIAN:
+        for (size_t i = 0; i < size; i += 2) {
+            // Box-Muller gives two independent normals per pair of uniforms
+            double r = sqrt(-2.0 * log(next_unit(&state)));
+            double theta = 6.283185307179586 * next_unit(&state);
+            data[i] = (int)(r * cos(theta) * 1e6);
+            if (i + 1 < size) data[i + 1] = (int)(r * sin(theta) * 1e6);
+        }
+        break;
+    default:
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+/*
+* @author   Jatin Jain
+* @file     gen.h
+* @desc     synthetic input distributions for benchmarking the sort engines.
+* @date     17 october 2026
+*/
+
+#ifndef GEN_H
+#define GEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+    DIST_UNIFORM,
+    DIST_SORTED,
+    DIST_REVERSE,
+    DIST_ORGAN_PIPE,
+    DIST_SAWTOOTH,
+    DIST_FEW_UNIQUE,
+    DIST_ALL_EQUAL,
+    DIST_ZIPF,
+    DIST_GAUSSIAN,
+    DIST_COUNT
+} Distribution;
+
+const char *gen_name(Distribution dist);
+int gen_lookup(const char *name, Distribution *dist);
+int gen_fill(Distribution dist, int *data, size_t size, uint64_t seed);
+
+#endif
@@ -1 +1,4 @@
-CFLAGS = -ggdb -std=c99 -Wall -Wextra -pthread
\ No newline at end of file
+CFLAGS = -ggdb -O2 -std=c99 -Wall -Wextra -pthread -fPIC -fvisibility=hidden
+CXXFLAGS = -ggdb -O2 -std=c++17 -Wall -Wextra -pthread
+CLIBFLAGS = -lm
+BENCH_LIBFLAGS = -ltbb
\ No newline at end of file
@@ -0,0 +1,105 @@
+/*
+* @author   Jatin Jain
+* @file     keys.c
+* @desc     normalised keys: the fields of a composite key, each encoded with keys.h, complemented if descending and
+*           written big-endian one after the other, so that comparing two normalised keys byte by byte (memcmp) or as
+*           big-endian words orders them like the fields compared one by one. Any key built from the SortKeyType fields
+*           can then be sorted by the unsigned radix engine.
+* @date     17 october 2026
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "threadedsort.h"
+#include "keys.h"
+
+static const size_t field_widths[] = {
+    [SORT_KEY_INT32] = 4, [SORT_KEY_UINT32] = 4, [SORT_KEY_INT64] = 8,
+    [SORT_KEY_UINT64] = 8, [SORT_KEY_FLOAT] = 4, [SORT_KEY_DOUBLE] = 8,
+};
+
+/**
+ * @brief Bytes of the normalised key of fields: the sum of the widths of the field types.
+ *
+ * @return The width, or 0 if a field has an unsupported type.
+ */
+size_t sort_key_width(const SortKeyField *fields, size_t field_count) {
+    size_t width = 0;
+    for (size_t f = 0; f < field_count; f++) {
+        if ((unsigned)fields[f].type > SORT_KEY_DOUBLE) return 0;
+        width += field_widths[fields[f].type];
+    }
+    return width;
+}
+
+/**
+ * @brief Writes the low width bytes of key to out, most significant first.
+ */
+static void put_big_endian(unsigned char *out, uint64_t key, size_t width) {
+    for (size_t i = width; i-- > 0; key >>= 8) out[i] = (unsigned char)key;
+}
+
+/**
+ * @brief Writes the normalised key of a record to out, sort_key_width() bytes.
+ *
+ * Each field is read from record at its offset (unaligned is fine) and
+ * encoded so that its unsigned big-endian bytes order like its values:
+ * signed integers flip the sign bit, floating point values follow IEEE
+ * total order. Descending fields are complemented. NaNs encode as all ones
+ * in both directions, so they go last. The fields must have supported
+ * types (sort_key_width() is not 0).
+ */
+void sort_key_encode(const SortKeyField *fields, size_t field_count, const void *record, unsigned char *out) {
+    for (size_t f = 0; f < field_count; f++) {
+        const unsigned char *value = (const unsigned char *)record + fields[f].offset;
+        size_t width = field_widths[fields[f].type];
+        uint64_t key = 0;
+        int nan = 0;
+        switch (fields[f].type) {
+        case SORT_KEY_INT32: {
+            int32_t v;
+            memcpy(&v, value, sizeof(v));
+            key = encode_int32(v);
+            break;
+        }
+        case SORT_KEY_UINT32: {
+            uint32_t v;
+            memcpy(&v, value, sizeof(v));
+            key = encode_uint32(v);
+            break;
+        }
+        case SORT_KEY_INT64: {
+            int64_t v;
+            memcpy(&v, value, sizeof(v));
+            key = encode_int64(v);
+            break;
+        }
+        case SORT_KEY_UINT64: {
+            uint64_t v;
+            memcpy(&v, value, sizeof(v));
+            key = encode_uint64(v);
+            break;
+        }
+        case SORT_KEY_FLOAT: {
+            float v;
+            memcpy(&v, value, sizeof(v));
+            nan = isnan(v);
+            key = encode_float(v);
+            break;
+        }
+        case SORT_KEY_DOUBLE: {
+            double v;
+            memcpy(&v, value, sizeof(v));
+            nan = isnan(v);
+            key = encode_double(v);
+            break;
+        }
+        }
+        if (nan) key = UINT64_MAX;
+        else if (fields[f].order == SORT_DESCENDING) key = ~key;
+        put_big_endian(out, key, width);
+        out += width;
+    }
+}
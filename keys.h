@@ -0,0 +1,57 @@
+/*
+* @author   Jatin Jain
+* @file     keys.h
+* @desc     order-preserving key encodings, internal to libthreadedsort: each maps a value to an unsigned integer of the
+*           same width whose unsigned order is the order of the values, and back. Shared by the typed sorts of
+*           threadedsort.c, the column sort and the normalised keys of keys.c; inline so the encoding loops do not pay for
+*           a call per value.
+* @date     17 october 2026
+*/
+
+#ifndef KEYS_H
+#define KEYS_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Order-preserving keys. Signed integers flip the sign bit. Floating point
+ * values flip the sign bit of positives and every bit of negatives, so
+ * -0.0 sorts below +0.0 and larger magnitudes of negatives sort lower.
+ */
+static inline uint32_t encode_int32(int32_t v) { return (uint32_t)v ^ 0x80000000u; }
+static inline int32_t decode_int32(uint32_t k) { return (int32_t)(k ^ 0x80000000u); }
+static inline uint32_t encode_uint32(uint32_t v) { return v; }
+static inline uint32_t decode_uint32(uint32_t k) { return k; }
+static inline uint64_t encode_int64(int64_t v) { return (uint64_t)v ^ 0x8000000000000000u; }
+static inline int64_t decode_int64(uint64_t k) { return (int64_t)(k ^ 0x8000000000000000u); }
+static inline uint64_t encode_uint64(uint64_t v) { return v; }
+static inline uint64_t decode_uint64(uint64_t k) { return k; }
+
+static inline uint32_t encode_float(float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits ^ ((uint32_t)-(int32_t)(bits >> 31) | 0x80000000u);
+}
+
+static inline float decode_float(uint32_t k) {
+    uint32_t bits = k ^ (((k >> 31) - 1u) | 0x80000000u);
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static inline uint64_t encode_double(double v) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits ^ ((uint64_t)-(int64_t)(bits >> 63) | 0x8000000000000000u);
+}
+
+static inline double decode_double(uint64_t k) {
+    uint64_t bits = k ^ (((k >> 63) - 1u) | 0x8000000000000000u);
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+#endif
@@ -0,0 +1,198 @@
+/*
+* @author   Jatin Jain
+* @file     kmerge.c
+* @desc     loser tree k-way merge. Each output element costs one replay of log2(k) matches along the winner's path, and each
+*           match is a branch-free compare-and-select on the encoded keys.
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kmerge.h"
+
+/**
+ * @brief Allocates a loser tree for k sources with every source exhausted.
+ *
+ * Set keys[0..k) to the first key of each source and call loser_tree_build()
+ * before reading the winner. tree is allocated with 2k slots, the upper half
+ * holds the subtree winners while the tree is built.
+ *
+ * @param[out] lt The tree to initialise.
+ * @param[in]  k  Number of sources, at least one.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int loser_tree_init(LoserTree *lt, size_t k) {
+    lt->k = 1;
+    while (lt->k < k) lt->k *= 2;
+    lt->tree = malloc(2 * lt->k * sizeof(size_t));
+    lt->keys = malloc(lt->k * sizeof(uint64_t));
+    if (!lt->tree || !lt->keys) {
+        perror("Memory allocation failed");
+        loser_tree_free(lt);
+        return -1;
+    }
+    for (size_t i = 0; i < lt->k; i++) lt->keys[i] = KMERGE_EXHAUSTED;
+    return 0;
+}
+
+/**
+ * @brief Frees the tree and its keys.
+ */
+void loser_tree_free(LoserTree *lt) {
+    free(lt->tree);
+    free(lt->keys);
+    lt->tree = NULL;
+    lt->keys = NULL;
+}
+
+/**
+ * @brief Plays every match bottom up from the current keys.
+ */
+void loser_tree_build(LoserTree *lt) {
+    size_t k = lt->k;
+    size_t *winners = lt->tree + k;
+    for (size_t node = k - 1; node >= 1; node--) {
+        size_t left = 2 * node, right = left + 1;
+        size_t a = left >= k ? left - k : winners[left];
+        size_t b = right >= k ? right - k : winners[right];
+        int b_wins = lt->keys[b] < lt->keys[a];
+        winners[node] = b_wins ? b : a;
+        lt->tree[node] = b_wins ? a : b;
+    }
+    lt->tree[0] = k > 1 ? winners[1] : 0;
+}
+
+/**
+ * @brief Replays the matches on the path of the winner after its key changed.
+ */
+void loser_tree_replay(LoserTree *lt) {
+    size_t winner = lt->tree[0];
+    const uint64_t *keys = lt->keys;
+    for (size_t node = (winner + lt->k) / 2; node >= 1; node /= 2) {
+        size_t loser = lt->tree[node];
+        int swap = keys[loser] < keys[winner];
+        lt->tree[node] = swap ? winner : loser;
+        winner = swap ? loser : winner;
+    }
+    lt->tree[0] = winner;
+}
+
+/**
+ * @brief Merges k sorted arrays into out.
+ *
+ * @param[in]  runs  The sorted arrays.
+ * @param[in]  sizes Number of elements in each array.
+ * @param[in]  k     Number of arrays.
+ * @param[out] out   Receives the sum of sizes elements in sorted order.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int kmerge_arrays(const int *const *runs, const size_t *sizes, size_t k, int *out) {
+    if (k == 0) return 0;
+    if (k == 1) {
+        memcpy(out, runs[0], sizes[0] * sizeof(int));
+        return 0;
+    }
+
+    LoserTree lt;
+    size_t *pos = calloc(k, sizeof(size_t));
+    if (!pos || loser_tree_init(&lt, k) < 0) {
+        if (!pos) perror("Memory allocation failed");
+        free(pos);
+        return -1;
+    }
+    for (size_t i = 0; i < k; i++)
+        if (sizes[i]) lt.keys[i] = kmerge_key(runs[i][0]);
+    loser_tree_build(&lt);
+
+    for (;;) {
+        size_t w = lt.tree[0];
+        uint64_t key = lt.keys[w];
+        if (key == KMERGE_EXHAUSTED) break;
+        *out++ = kmerge_value(key);
+        size_t next = ++pos[w];
+        lt.keys[w] = next < sizes[w] ? kmerge_key(runs[w][next]) : KMERGE_EXHAUSTED;
+        loser_tree_replay(&lt);
+    }
+
+    free(pos);
+    loser_tree_free(&lt);
+    return 0;
+}
+
+/**
+ * @brief Merges k sorted streams into a sink.
+ *
+ * Each source is read in blocks of buffer_ints through its fill callback and
+ * the output is handed to the sink in blocks of the same size. A source
+ * whose values go down is reported as not sorted.
+ *
+ * @param[in] sources     The sorted streams.
+ * @param[in] k           Number of streams.
+ * @param[in] buffer_ints Block size, in ints, of each input buffer and of the output buffer.
+ * @param[in] sink        Receives the merged values.
+ * @return 0 on success, or -1 if a callback fails, a source is not sorted or memory allocation fails.
+ */
+int kmerge_streams(const KMergeSource *sources, size_t k, size_t buffer_ints, const KMergeSink *sink) {
+    if (buffer_ints == 0) buffer_ints = 1;
+    LoserTree lt = {0, NULL, NULL};
+    int **bufs = calloc(k, sizeof(int *));
+    size_t *pos = calloc(k, sizeof(size_t));
+    size_t *len = calloc(k, sizeof(size_t));
+    int *out = malloc(buffer_ints * sizeof(int));
+    size_t out_len = 0;
+    int status = -1;
+
+    if (!bufs || !pos || !len || !out) {
+        perror("Memory allocation failed");
+        goto done;
+    }
+    if (k > 0 && loser_tree_init(&lt, k) < 0) goto done;
+    for (size_t i = 0; i < k; i++) {
+        bufs[i] = malloc(buffer_ints * sizeof(int));
+        if (!bufs[i]) {
+            perror("Memory allocation failed");
+            goto done;
+        }
+        if (sources[i].fill(sources[i].ctx, bufs[i], buffer_ints, &len[i]) < 0) goto done;
+        if (len[i]) lt.keys[i] = kmerge_key(bufs[i][0]);
+    }
+
+    if (k > 0) {
+        loser_tree_build(&lt);
+        for (;;) {
+            size_t w = lt.tree[0];
+            uint64_t key = lt.keys[w];
+            if (key == KMERGE_EXHAUSTED) break;
+            out[out_len++] = kmerge_value(key);
+            if (out_len == buffer_ints) {
+                if (sink->flush(sink->ctx, out, out_len) < 0) goto done;
+                out_len = 0;
+            }
+
+            if (++pos[w] == len[w]) {
+                if (sources[w].fill(sources[w].ctx, bufs[w], buffer_ints, &len[w]) < 0) goto done;
+                pos[w] = 0;
+            }
+            uint64_t next = pos[w] < len[w] ? kmerge_key(bufs[w][pos[w]]) : KMERGE_EXHAUSTED;
+            if (next < key) {
+                fprintf(stderr, "Merge input %zu is not sorted\n", w);
+                goto done;
+            }
+            lt.keys[w] = next;
+            loser_tree_replay(&lt);
+        }
+    }
+    if (out_len && sink->flush(sink->ctx, out, out_len) < 0) goto done;
+    status = 0;
+
+done:
+    for (size_t i = 0; bufs && i < k; i++) free(bufs[i]);
+    free(bufs);
+    free(pos);
+    free(len);
+    free(out);
+    loser_tree_free(&lt);
+    return status;
+}
@@ -0,0 +1,73 @@
+/*
+* @author   Jatin Jain
+* @file     kmerge.h
+* @desc     k-way merge of sorted int runs with a loser tree, over arrays in memory or over buffered streams.
+* @date     17 october 2026
+*/
+
+#ifndef KMERGE_H
+#define KMERGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define KMERGE_EXHAUSTED UINT64_MAX
+
+/**
+ * @brief Loser (tournament) tree over k sources.
+ *
+ * keys holds the encoded head of each source, KMERGE_EXHAUSTED once the
+ * source is empty. tree[0] is the index of the source with the smallest
+ * key and tree[1..k) the loser of the match played at each node. k is the
+ * number of sources rounded up to a power of two; the padding sources are
+ * exhausted from the start.
+ */
+typedef struct {
+    size_t k;
+    size_t *tree;
+    uint64_t *keys;
+} LoserTree;
+
+/**
+ * @brief Fills buf with up to capacity ints from a source; *len == 0 means the source is done.
+ * Returns 0 on success or -1 on error.
+ */
+typedef int (*KMergeFill)(void *ctx, int *buf, size_t capacity, size_t *len);
+
+/**
+ * @brief Consumes len merged ints. Returns 0 on success or -1 on error.
+ */
+typedef int (*KMergeFlush)(void *ctx, const int *buf, size_t len);
+
+typedef struct {
+    KMergeFill fill;
+    void *ctx;
+} KMergeSource;
+
+typedef struct {
+    KMergeFlush flush;
+    void *ctx;
+} KMergeSink;
+
+/**
+ * @brief Encodes an int so that unsigned comparison of the keys orders the
+ * values, leaving every key below KMERGE_EXHAUSTED. Matches become a single
+ * unsigned compare with no special case for finished sources.
+ */
+static inline uint64_t kmerge_key(int value) {
+    return (uint64_t)((uint32_t)value ^ 0x80000000u);
+}
+
+static inline int kmerge_value(uint64_t key) {
+    return (int)((uint32_t)key ^ 0x80000000u);
+}
+
+int loser_tree_init(LoserTree *lt, size_t k);
+void loser_tree_build(LoserTree *lt);
+void loser_tree_replay(LoserTree *lt);
+void loser_tree_free(LoserTree *lt);
+
+int kmerge_arrays(const int *const *runs, const size_t *sizes, size_t k, int *out);
+int kmerge_streams(const KMergeSource *sources, size_t k, size_t buffer_ints, const KMergeSink *sink);
+
+#endif
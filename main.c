@@ -0,0 +1,704 @@
+/*
+* @author   Jatin Jain
+* @file     main.c
+* @desc     command line front end: compares the threaded and non-threaded quicksort on a file of integers, or runs one of the subcommands below.
+* @usage    ./quicksort [-p] [-c] [-v] [--trace out.json | --indices | --top-k K | --quantiles Q,...] <filename.txt>
+*           ./quicksort extsort [-m MiB] [-T tmpdir] [-o output] <filename.txt>
+*           ./quicksort merge [-o output] <sorted.txt>...
+*           ./quicksort strings [-r] [-o output] <lines.txt>
+* @date     6 december 2024
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include "threadedsort.h"
+#include "extsort.h"
+#include "kmerge.h"
+#include "perfctr.h"
+#include "textio.h"
+#include "timing.h"
+#include "trace.h"
+#include "verify.h"
+
+#define MERGE_BUFFER_INTS (1 << 16)     // ints buffered per input by the merge subcommand
+#define STRINGS_CUTOFF (1 << 16)        // lines below which the strings subcommand stops starting threads
+
+/**
+ * @brief Prints a label followed by a comma separated list of integers.
+ */
+static void print_list(const char *label, const int *data, size_t size) {
+    printf("%s", label);
+    for (size_t i = 0; i < size; i++) {
+        printf("%d", data[i]);
+        if (i < size - 1) printf(", ");
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Sorts a copy of data with the sorter's engine.
+ *
+ * @return The newly allocated sorted copy, or NULL on failure (or for an empty input).
+ */
+static int *sorted_copy(Sorter *sorter, const int *data, size_t size) {
+    if (size == 0) return NULL;
+    int *sorted = malloc(size * sizeof(int));
+    if (sorted && sorter_sort_into(sorter, data, size, sorted) < 0) {
+        free(sorted);
+        sorted = NULL;
+    }
+    return sorted;
+}
+
+/**
+ * @brief Checks that both results are sorted and hold the same values.
+ *
+ * @return 1 if they match, 0 otherwise.
+ */
+static int results_match(const int *non_threaded, const int *threaded, size_t size) {
+    if (size == 0) return 1;
+    if (!non_threaded || !threaded) return 0;
+    for (size_t i = 0; i < size; i++) {
+        if (non_threaded[i] != threaded[i]) return 0;
+        if (i > 0 && non_threaded[i - 1] > non_threaded[i]) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Checks that one sort result is sorted and a permutation of the input, printing which result fails.
+ *
+ * @return 1 if it is, 0 otherwise.
+ */
+static int result_verified(const char *label, const int *result, size_t size, const Checksum *input) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (size > 0 && !result) {
+        fprintf(stderr, "%s sort failed\n", label);
+        return 0;
+    }
+    if (verify_sorted_permutation(result, size, input, cores > 0 ? (size_t)cores : 1) < 0) {
+        fprintf(stderr, "%s result failed verification\n", label);
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Writes the positions of data in sorted order to stdout, one per line.
+ *
+ * With a checksum, the positions are first checked to pick every input
+ * value once and in sorted order.
+ *
+ * @return 0 on success, or 1 if the sort, the check or the write fails.
+ */
+static int write_indices(const int *data, size_t size, const Checksum *checksum) {
+    Sorter *sorter = sorter_create();
+    size_t *indices = malloc((size ? size : 1) * sizeof(size_t));
+    int status = 1;
+    if (!sorter || !indices) {
+        perror("Memory allocation failed");
+        goto done;
+    }
+    if (sorter_argsort(sorter, SORT_KEY_INT32, data, size, indices) < 0) {
+        fprintf(stderr, "Sort failed\n");
+        goto done;
+    }
+    if (checksum) {
+        int *gathered = malloc((size ? size : 1) * sizeof(int));
+        if (!gathered) {
+            perror("Memory allocation failed");
+            goto done;
+        }
+        int in_range = 1;
+        for (size_t i = 0; i < size && in_range; i++) {
+            in_range = indices[i] < size;
+            if (in_range) gathered[i] = data[indices[i]];
+        }
+        if (!in_range) fprintf(stderr, "Index result out of range\n");
+        int verified = in_range && result_verified("Index", gathered, size, checksum);
+        free(gathered);
+        if (!verified) goto done;
+    }
+
+    TextWriter writer;
+    if (text_writer_open(&writer, NULL) < 0) goto done;
+    status = 0;
+    for (size_t i = 0; i < size && status == 0; i++)
+        if (text_writer_put_index(&writer, indices[i]) < 0) status = 1;
+    if (text_writer_close(&writer) < 0) status = 1;
+
+done:
+    sorter_destroy(sorter);
+    free(indices);
+    return status;
+}
+
+/**
+ * @brief Writes the k smallest values of data to stdout in ascending order, one per line.
+ *
+ * With check set, the result of the quickselect is compared with that of
+ * the streaming heap, which finds the same values independently.
+ *
+ * @return 0 on success, or 1 if the selection, the check or the write fails.
+ */
+static int write_top_k(const int *data, size_t size, size_t k, int check) {
+    if (k > size) k = size;
+    Sorter *sorter = sorter_create();
+    int *top = malloc((k ? k : 1) * sizeof(int));
+    TopK *heap = NULL;
+    int status = 1;
+    if (!sorter || !top) {
+        perror("Memory allocation failed");
+        goto done;
+    }
+    if (sorter_top_k(sorter, data, size, k, top) < 0) {
+        fprintf(stderr, "Top-k selection failed\n");
+        goto done;
+    }
+    if (check) {
+        int *expected = malloc((k ? k : 1) * sizeof(int));
+        heap = top_k_create(k, SORT_ASCENDING);
+        if (!expected || !heap) {
+            perror("Memory allocation failed");
+            free(expected);
+            goto done;
+        }
+        top_k_push(heap, data, size);
+        int same = top_k_result(heap, expected) == k && memcmp(expected, top, k * sizeof(int)) == 0;
+        free(expected);
+        if (!same) {
+            fprintf(stderr, "Top-k result failed verification\n");
+            goto done;
+        }
+    }
+
+    TextWriter writer;
+    if (text_writer_open(&writer, NULL) < 0) goto done;
+    status = 0;
+    for (size_t i = 0; i < k && status == 0; i++)
+        if (text_writer_put(&writer, top[i]) < 0) status = 1;
+    if (text_writer_close(&writer) < 0) status = 1;
+
+done:
+    top_k_destroy(heap);
+    sorter_destroy(sorter);
+    free(top);
+    return status;
+}
+
+/**
+ * @brief Parses a comma separated list of fractions, such as "0.5,0.99,0.999".
+ *
+ * @param[out] quantiles The fractions, allocated with malloc().
+ * @param[out] count     Their number.
+ * @return 0 on success, or -1 if an entry is not a number between 0 and 1.
+ */
+static int parse_quantiles(const char *list, double **quantiles, size_t *count) {
+    size_t capacity = 1;
+    for (const char *c = list; *c; c++) capacity += *c == ',';
+    *quantiles = malloc(capacity * sizeof(double));
+    *count = 0;
+    if (!*quantiles) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+    const char *next = list;
+    for (;;) {
+        char *end;
+        double q = strtod(next, &end);
+        if (end == next || (*end != ',' && *end != '\0') || !(q >= 0.0 && q <= 1.0)) {
+            fprintf(stderr, "Invalid quantile list: %s\n", list);
+            free(*quantiles);
+            *quantiles = NULL;
+            return -1;
+        }
+        (*quantiles)[(*count)++] = q;
+        if (*end == '\0') return 0;
+        next = end + 1;
+    }
+}
+
+/**
+ * @brief Writes the given quantiles of data to stdout, one per line in the order given.
+ *
+ * All the quantiles are answered by one multi-rank selection. With check
+ * set, they are compared with the same ranks of a copy of data sorted serially.
+ *
+ * @return 0 on success, or 1 if the selection, the check or the write fails.
+ */
+static int write_quantiles(const int *data, size_t size, const double *quantiles, size_t count, int check) {
+    if (size == 0) return 0;
+    Sorter *sorter = sorter_create();
+    int *values = malloc(count * sizeof(int));
+    int *sorted = NULL;
+    int status = 1;
+    if (!sorter || !values) {
+        perror("Memory allocation failed");
+        goto done;
+    }
+    if (sorter_quantiles(sorter, data, size, quantiles, count, values) < 0) {
+        fprintf(stderr, "Quantile selection failed\n");
+        goto done;
+    }
+    if (check) {
+        sorted = malloc(size * sizeof(int));
+        if (!sorted) {
+            perror("Memory allocation failed");
+            goto done;
+        }
+        memcpy(sorted, data, size * sizeof(int));
+        sorter_set_engine(sorter, SORT_ENGINE_SERIAL);
+        if (sorter_sort(sorter, sorted, size) < 0) {
+            fprintf(stderr, "Sort failed\n");
+            goto done;
+        }
+        for (size_t q = 0; q < count; q++) {
+            // nearest rank: the smallest value with at least a fraction q of the data at or below it
+            double position = ceil(quantiles[q] * (double)size);
+            size_t rank = position < 1.0 ? 0 : (size_t)position - 1;
+            if (sorted[rank < size ? rank : size - 1] != values[q]) {
+                fprintf(stderr, "Quantile result failed verification\n");
+                goto done;
+            }
+        }
+    }
+
+    TextWriter writer;
+    if (text_writer_open(&writer, NULL) < 0) goto done;
+    status = 0;
+    for (size_t q = 0; q < count && status == 0; q++)
+        if (text_writer_put(&writer, values[q]) < 0) status = 1;
+    if (text_writer_close(&writer) < 0) status = 1;
+
+done:
+    sorter_destroy(sorter);
+    free(values);
+    free(sorted);
+    return status;
+}
+
+/** 
+ * @brief Sorts integers using both non-threaded and threaded quicksort.
+ * 
+ * This program reads integers from a file, performs non-threaded quicksort and threaded quicksort on the data, 
+ * compares their execution times, and optionally prints the unsorted and sorted results if the "-p" flag is used.
+ * Sort times are wall clock times. A report with the wall and CPU time of every phase (load, parse, sort,
+ * sort_threaded, verify, write) is printed at the end.
+ * 
+ * Usage: 
+ *   ./quicksort [-p] [-c] [-v] [--trace out.json | --indices | --top-k K | --quantiles Q,...] <file_of_integers>
+ * 
+ * - If `-p` is provided, the program will print the unsorted and sorted lists.
+ * - If `-c` is provided, hardware counters (cycles, instructions, branch, LLC and dTLB misses) are read around
+ *   every parse, partition, merge and leaf sort, and printed per phase as IPC and misses per thousand instructions.
+ * - If `--trace` (or `-t`) is provided, every task of the threaded sort is written to the given file in Chrome
+ *   Trace Event format with its thread, subarray size and recursion depth, split into partition, wait and merge.
+ *   It cannot be combined with `--indices`, `--top-k` or `--quantiles`, which do not run the threaded sort.
+ * - If `--verify` (or `-v`) is provided, each result is checked in parallel to be sorted and to have the same
+ *   order-independent checksum as the input (computed while parsing), instead of comparing the two results.
+ * - If `--indices` (or `-i`) is provided, only the positions of the input values in sorted order (0-based, equal
+ *   values in input order) are written to stdout, one per line, from an argsort of the input; nothing is timed.
+ * - If `--top-k` (or `-k`) is provided, only the K smallest values are written to stdout in ascending order, one
+ *   per line. They are selected with a quickselect on the three-way partition, so only they get sorted; with
+ *   `--verify` they are checked against a heap selection. Nothing is timed.
+ * - If `--quantiles` (or `-q`) is provided with a comma separated list of fractions between 0 and 1, only the
+ *   nearest-rank quantile of each is written to stdout, one per line in the order given. They are all found by one
+ *   parallel multi-rank selection; with `--verify` they are checked against a full sort. Nothing is timed.
+ * - Reads integers from the provided input file and sorts them using two sorting methods.
+ * 
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Returns 0 on successful execution, or 1 if an error occurs or the two results differ.
+ */
+static int sort_command(int argc, char *argv[]) {
+    
+    int print_flag = 0; // Flag to determine if the program should print results
+    int counters_flag = 0; // Flag to determine if hardware counters should be reported
+    int verify_flag = 0; // Flag to determine if each result should be checked against the input checksum
+    int indices_flag = 0; // Flag to determine if only the sorted order of the input should be written
+    int top_k_flag = 0; // Flag to determine if only the smallest top_k values should be written
+    size_t top_k = 0;
+    double *quantiles = NULL; // Fractions whose quantiles should be written, if any
+    size_t quantile_count = 0;
+    const char *trace_path = NULL; // Where to write the task trace of the threaded sort, if anywhere
+    static const struct option long_options[] = {
+        {"trace", required_argument, NULL, 't'},
+        {"verify", no_argument, NULL, 'v'},
+        {"indices", no_argument, NULL, 'i'},
+        {"top-k", required_argument, NULL, 'k'},
+        {"quantiles", required_argument, NULL, 'q'},
+        {NULL, 0, NULL, 0}
+    };
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "pcvik:q:t:", long_options, NULL)) != -1) {
+        if (opt == 'p') print_flag = 1;
+        else if (opt == 'c') counters_flag = 1;
+        else if (opt == 'v') verify_flag = 1;
+        else if (opt == 'i') indices_flag = 1;
+        else if (opt == 'k') {
+            char *end;
+            unsigned long long k = strtoull(optarg, &end, 10);
+            if (*end != '\0' || optarg[0] == '-') {
+                fprintf(stderr, "Invalid top-k count: %s\n", optarg);
+                return 1;
+            }
+            top_k_flag = 1;
+            top_k = (size_t)k;
+        }
+        else if (opt == 'q') {
+            free(quantiles);
+            if (parse_quantiles(optarg, &quantiles, &quantile_count) < 0) return 1;
+        }
+        else if (opt == 't') trace_path = optarg;
+        else {
+            fprintf(stderr, "Usage: %s [-p] [-c] [-v] [--trace out.json | --indices | --top-k K | --quantiles Q,...] "
+                    "file_of_integers\n", argv[0]);
+            free(quantiles);
+            return 1;
+        }
+    }
+    // the selection modes never run the traced threaded sort, so a trace would silently not be written
+    if (optind != argc - 1 || (trace_path != NULL) + indices_flag + top_k_flag + (quantiles != NULL) > 1) {
+        fprintf(stderr, "Usage: %s [-p] [-c] [-v] [--trace out.json | --indices | --top-k K | --quantiles Q,...] "
+                "file_of_integers\n", argv[0]);
+        free(quantiles);
+        return 1;
+    }
+    char *filename = argv[optind];
+    if (counters_flag && perf_init() < 0) {
+        free(quantiles);
+        return 1;
+    }
+
+    TimingReport report;
+    timing_init(&report);
+
+    // Load the file into memory, then parse the integers out of it
+    char *text;
+    size_t text_len;
+    timing_begin(&report, "load");
+    if (text_load(filename, &text, &text_len) < 0) {
+        free(quantiles);
+        return 1;
+    }
+
+    int *data;
+    size_t size;
+    Checksum input_checksum;
+    timing_begin(&report, "parse");
+    perf_begin(PERF_PARSE);
+    int parsed = text_parse(text, text_len, &data, &size, verify_flag ? &input_checksum : NULL);
+    perf_end(PERF_PARSE);
+    timing_end(&report);
+    free(text);
+    if (parsed < 0) {
+        free(quantiles);
+        return 1;
+    }
+    if (indices_flag) {
+        int status = write_indices(data, size, verify_flag ? &input_checksum : NULL);
+        free(data);
+        return status;
+    }
+    if (top_k_flag) {
+        int status = write_top_k(data, size, top_k, verify_flag);
+        free(data);
+        return status;
+    }
+    if (quantiles) {
+        int status = write_quantiles(data, size, quantiles, quantile_count, verify_flag);
+        free(quantiles);
+        free(data);
+        return status;
+    }
+    Sorter *sorter = sorter_create();
+    if (!sorter) {
+        perror("Memory allocation failed");
+        free(data);
+        return 1;
+    }
+
+    // Print the unsorted list if print_flag is set
+    if (print_flag) {
+        timing_begin(&report, "write");
+        print_list("Unsorted list before non-threaded quicksort: ", data, size);
+        timing_end(&report);
+    }
+
+    // Perform non-threaded quicksort and measure its execution time
+    timing_begin(&report, "sort");
+    sorter_set_engine(sorter, SORT_ENGINE_SERIAL);
+    int *sorted_non_threaded = sorted_copy(sorter, data, size);
+    timing_end(&report);
+    printf("Non-threaded time:  %f\n", timing_phase_wall(&report, "sort"));
+
+    // Print the sorted list if print_flag is set
+    if (print_flag && sorted_non_threaded) {
+        timing_begin(&report, "write");
+        print_list("Resulting list: ", sorted_non_threaded, size);
+        print_list("Unsorted list before threaded quicksort: ", data, size);
+        timing_end(&report);
+    }
+
+    // Perform threaded quicksort and measure its execution time
+    timing_begin(&report, "sort_threaded");
+    // The root task runs in this thread; trace the tasks if asked to
+    if (trace_path) trace_start();
+    sorter_set_engine(sorter, SORT_ENGINE_THREADED);
+    int *sorted_threaded = sorted_copy(sorter, data, size);
+    timing_end(&report);
+    int traced = trace_path ? trace_write(trace_path) : 0;
+    SortStats stats = *sorter_stats(sorter);
+    sorter_destroy(sorter);
+
+    // Threads spawned during the execution
+    printf("Threaded time:      %f\n", timing_phase_wall(&report, "sort_threaded"));
+    printf("Threads spawned:    %zu\n", stats.threads_spawned);
+
+    // Print the sorted threaded result if the print_flag is set
+    if (print_flag && sorted_threaded) {
+        timing_begin(&report, "write");
+        print_list("Resulting list: ", sorted_threaded, size);
+        timing_end(&report);
+    }
+
+    // Both sorts must produce the same sorted list; with --verify, each must be a sorted permutation of the input
+    timing_begin(&report, "verify");
+    int verified;
+    if (verify_flag) {
+        verified = result_verified("Non-threaded", sorted_non_threaded, size, &input_checksum);
+        verified &= result_verified("Threaded", sorted_threaded, size, &input_checksum);
+    } else
+        verified = results_match(sorted_non_threaded, sorted_threaded, size);
+    timing_end(&report);
+
+    printf("\n");
+    timing_print(&report, stdout);
+    printf("\n");
+    sort_stats_print(&stats, stdout);
+    if (counters_flag) {
+        printf("\n");
+        perf_print(stdout);
+    }
+    if (!verified && !verify_flag) fprintf(stderr, "Threaded and non-threaded results differ\n");
+
+    // Free dynamically allocated memory
+    free(data);
+    free(sorted_non_threaded);
+    free(sorted_threaded);
+
+    return verified && traced == 0 ? 0 : 1;
+}
+
+
+/**
+ * @brief Sorts a file of integers that may not fit in memory.
+ *
+ * Usage:
+ *   ./quicksort extsort [-m MiB] [-T tmpdir] [-o output] <file_of_integers>
+ *
+ * - `-m` sets the memory budget in MiB (default 256). Chunks, sort scratch, the run being written and the merge
+ *   buffers all fit in it; peak memory is the budget plus about 8 MiB for the text reader and writer.
+ * - `-T` sets the directory for the spilled runs (default $TMPDIR or /tmp).
+ * - `-o` sets the output file, one integer per line (default stdout).
+ *
+ * @param program Name the program was run as, for the usage message.
+ * @param argc Argument count, starting at the subcommand name.
+ * @param argv Argument vector, starting at the subcommand name.
+ * @return Returns 0 on success, or 1 if an error occurs.
+ */
+static int extsort_command(const char *program, int argc, char *argv[]) {
+    ExtSortConfig config;
+    extsort_config_init(&config);
+    const char *output = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:T:o:")) != -1) {
+        switch (opt) {
+        case 'm': {
+            char *end;
+            unsigned long long mib = strtoull(optarg, &end, 10);
+            if (*end != '\0' || mib == 0) {
+                fprintf(stderr, "Invalid memory budget: %s\n", optarg);
+                return 1;
+            }
+            config.memory_budget = (size_t)mib << 20;
+            break;
+        }
+        case 'T':
+            config.tmp_dir = optarg;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s extsort [-m MiB] [-T tmpdir] [-o output] file_of_integers\n", program);
+            return 1;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Usage: %s extsort [-m MiB] [-T tmpdir] [-o output] file_of_integers\n", program);
+        return 1;
+    }
+
+    return external_sort(argv[optind], output, &config) < 0 ? 1 : 0;
+}
+
+
+/**
+ * @brief Merges files of already sorted integers without sorting them again.
+ *
+ * Usage:
+ *   ./quicksort merge [-o output] <sorted_file>...
+ *
+ * - `-o` sets the output file, one integer per line (default stdout).
+ * - Every input must be sorted in ascending order, e.g. the output of a previous sort or extsort.
+ *
+ * @param program Name the program was run as, for the usage message.
+ * @param argc Argument count, starting at the subcommand name.
+ * @param argv Argument vector, starting at the subcommand name.
+ * @return Returns 0 on success, or 1 if an error occurs or an input is not sorted.
+ */
+static int merge_command(const char *program, int argc, char *argv[]) {
+    const char *output = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        if (opt != 'o') {
+            fprintf(stderr, "Usage: %s merge [-o output] sorted_file...\n", program);
+            return 1;
+        }
+        output = optarg;
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "Usage: %s merge [-o output] sorted_file...\n", program);
+        return 1;
+    }
+
+    size_t k = (size_t)(argc - optind);
+    TextReader *readers = malloc(k * sizeof(TextReader));
+    KMergeSource *sources = malloc(k * sizeof(KMergeSource));
+    TextWriter writer;
+    size_t opened = 0;
+    int status = 1;
+
+    if (!readers || !sources) {
+        perror("Memory allocation failed");
+        goto done;
+    }
+    for (; opened < k; opened++) {
+        if (text_reader_open(&readers[opened], argv[optind + opened]) < 0) goto done;
+        sources[opened].fill = text_reader_read;
+        sources[opened].ctx = &readers[opened];
+    }
+    if (text_writer_open(&writer, output) < 0) goto done;
+
+    KMergeSink sink = {text_writer_write, &writer};
+    status = kmerge_streams(sources, k, MERGE_BUFFER_INTS, &sink) < 0;
+    if (text_writer_close(&writer) < 0) status = 1;
+
+done:
+    for (size_t i = 0; i < opened; i++) text_reader_close(&readers[i]);
+    free(readers);
+    free(sources);
+    return status;
+}
+
+
+/**
+ * @brief Sorts the lines of a text file in byte order (the order of strcmp()).
+ *
+ * Usage:
+ *   ./quicksort strings [-r] [-o output] <file_of_lines>
+ *
+ * - `-r` sorts in descending order.
+ * - `-o` sets the output file, one line per line (default stdout).
+ * - The file is loaded into one buffer whose newlines become terminators, so the lines are sorted as pointers into
+ *   that arena with the parallel string sort, without copying them.
+ *
+ * @param program Name the program was run as, for the usage message.
+ * @param argc Argument count, starting at the subcommand name.
+ * @param argv Argument vector, starting at the subcommand name.
+ * @return Returns 0 on success, or 1 if an error occurs.
+ */
+static int strings_command(const char *program, int argc, char *argv[]) {
+    const char *output = NULL;
+    SortOrder order = SORT_ASCENDING;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "ro:")) != -1) {
+        switch (opt) {
+        case 'r':
+            order = SORT_DESCENDING;
+            break;
+        case 'o':
+            output = optarg;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s strings [-r] [-o output] file_of_lines\n", program);
+            return 1;
+        }
+    }
+    if (optind != argc - 1) {
+        fprintf(stderr, "Usage: %s strings [-r] [-o output] file_of_lines\n", program);
+        return 1;
+    }
+
+    char *text;
+    size_t text_len, count;
+    const char **lines = NULL;
+    Sorter *sorter = NULL;
+    int status = 1;
+    if (text_load(argv[optind], &text, &text_len) < 0) return 1;
+    if (text_split_lines(text, text_len, &lines, &count) < 0) goto done;
+    sorter = sorter_create();
+    if (!sorter) {
+        perror("Memory allocation failed");
+        goto done;
+    }
+    sorter_set_cutoff(sorter, STRINGS_CUTOFF);
+    sorter_set_order(sorter, order);
+    if (sorter_sort_strings(sorter, lines, count) < 0) {
+        fprintf(stderr, "Sort failed\n");
+        goto done;
+    }
+
+    TextWriter writer;
+    if (text_writer_open(&writer, output) < 0) goto done;
+    status = 0;
+    for (size_t i = 0; i < count && status == 0; i++)
+        if (text_writer_put_line(&writer, lines[i], strlen(lines[i])) < 0) status = 1;
+    if (text_writer_close(&writer) < 0) status = 1;
+
+done:
+    sorter_destroy(sorter);
+    free(lines);
+    free(text);
+    return status;
+}
+
+
+/**
+ * @brief Main function, dispatches to a subcommand or to the default sort comparison.
+ *
+ * @param argc Argument count.
+ * @param argv Argument vector.
+ * @return Returns 0 on successful execution, or 1 if an error occurs.
+ */
+int main(int argc, char *argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "extsort") == 0)
+        return extsort_command(argv[0], argc - 1, argv + 1);
+    if (argc >= 2 && strcmp(argv[1], "merge") == 0)
+        return merge_command(argv[0], argc - 1, argv + 1);
+    if (argc >= 2 && strcmp(argv[1], "strings") == 0)
+        return strings_command(argv[0], argc - 1, argv + 1);
+    return sort_command(argc, argv);
+}
@@ -0,0 +1,42 @@
+/*
+* @author   Jatin Jain
+* @file     memtrack.h
+* @desc     allocation tracking of the sort engines: counting wrappers around malloc/free that keep the live, peak and total
+*           bytes, and the peak resident set size of the process.
+* @date     17 october 2026
+*/
+
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include <stddef.h>
+
+/**
+ * @brief Memory used since the last memtrack_reset().
+ *
+ * The byte counts cover the allocations made through memtrack_malloc(); the
+ * peak resident set size also covers memory that other code (libc, the C++
+ * standard library) allocates on its own. It is -1 when it cannot be read.
+ */
+typedef struct {
+    size_t allocations;
+    size_t bytes_allocated;
+    size_t peak_live_bytes;
+    long max_rss_kib;
+} MemUsage;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void memtrack_enable(int on);
+void memtrack_reset(void);
+void *memtrack_malloc(size_t bytes);
+void memtrack_free(void *ptr, size_t bytes);
+void memtrack_read(MemUsage *usage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,171 @@
+/*
+* @author   Jatin Jain
+* @file     multikey.c
+* @desc     multikey quicksort on cached integer keys. The items are three-way partitioned on their key at the current
+*           level; the less and more parts are sorted on the same level and the equal part moves on to the next one,
+*           whose keys are only loaded for the items that tie. The task tree follows quicksort_threaded(): the less and
+*           more parts run in new threads while the parent sorts the equal part, the thread budget is split between the
+*           parts by size, and parts below the cutoff or with a budget of one thread are sorted serially.
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "multikey.h"
+#include "quicksort.h"
+#include "timing.h"
+
+#define MULTIKEY_INSERTION_MAX 16       // below this many items, insertion sort
+
+/**
+ * @brief Arguments of one multikey sorting task, like ThreadArgs.
+ */
+typedef struct {
+    MultikeyItem *items;
+    size_t size;
+    size_t level;
+    size_t cutoff;
+    size_t threads;
+    const MultikeyOps *ops;
+    SortStats stats;
+} MultikeyTask;
+
+static uint64_t median_of_three(uint64_t a, uint64_t b, uint64_t c) {
+    if (a < b) return b < c ? b : a < c ? c : a;
+    return a < c ? a : b < c ? c : b;
+}
+
+/**
+ * @brief Three-way partitions items by their key around the median of three keys.
+ *
+ * @param[out] less_size  Items with a smaller key, moved to the front.
+ * @param[out] equal_size Items with the pivot's key, moved next.
+ * @return The pivot's key.
+ */
+static uint64_t partition_items(MultikeyItem *items, size_t size, size_t *less_size, size_t *equal_size) {
+    uint64_t pivot = median_of_three(items[0].key, items[size / 2].key, items[size - 1].key);
+    size_t lt = 0, i = 0, gt = size;
+    while (i < gt) {
+        if (items[i].key < pivot) {
+            MultikeyItem t = items[lt];
+            items[lt++] = items[i];
+            items[i++] = t;
+        } else if (items[i].key > pivot) {
+            MultikeyItem t = items[--gt];
+            items[gt] = items[i];
+            items[i] = t;
+        } else {
+            i++;
+        }
+    }
+    *less_size = lt;
+    *equal_size = gt - lt;
+    return pivot;
+}
+
+/**
+ * @brief Sorts items that are equal before level, serially. Their keys must be loaded for level.
+ */
+static void sort_serial(MultikeyItem *items, size_t size, size_t level, const MultikeyOps *ops, SortStats *stats) {
+    while (size > 1) {
+        if (size < MULTIKEY_INSERTION_MAX) {
+            for (size_t i = 1; i < size; i++) {
+                MultikeyItem item = items[i];
+                size_t j = i;
+                for (; j > 0 && ops->compare(&items[j - 1], &item, level, ops->context) > 0; j--)
+                    items[j] = items[j - 1];
+                items[j] = item;
+            }
+            return;
+        }
+        size_t less_size, equal_size;
+        uint64_t pivot = partition_items(items, size, &less_size, &equal_size);
+        stats->elements_partitioned += size;
+        sort_serial(items, less_size, level, ops, stats);
+        sort_serial(items + less_size + equal_size, size - less_size - equal_size, level, ops, stats);
+        if (ops->last(pivot, level, ops->context)) return;
+        // continue with the equal part on the next level, without recursing
+        items += less_size;
+        size = equal_size;
+        level++;
+        if (size > 1) ops->load(items, size, level, ops->context);
+    }
+}
+
+/**
+ * @brief Thread body: sorts the items of a MultikeyTask, filling in its stats.
+ */
+static void *multikey_task(void *arg) {
+    MultikeyTask *task = arg;
+    MultikeyItem *items = task->items;
+    size_t size = task->size, level = task->level;
+    const MultikeyOps *ops = task->ops;
+    SortStats *stats = &task->stats;
+    memset(stats, 0, sizeof(*stats));
+    stats->tasks = 1;
+    if (size < task->cutoff || task->threads == 1 || size < MULTIKEY_INSERTION_MAX) {
+        sort_serial(items, size, level, ops, stats);
+        return NULL;
+    }
+
+    size_t less_size, equal_size;
+    uint64_t pivot = partition_items(items, size, &less_size, &equal_size);
+    size_t more_size = size - less_size - equal_size;
+    stats->elements_partitioned += size;
+    int equal_done = ops->last(pivot, level, ops->context);
+
+    MultikeyTask less = {items, less_size, level, task->cutoff, sort_budget_share(task->threads, less_size, size),
+                         ops, {0}};
+    MultikeyTask more = {items + less_size + equal_size, more_size, level, task->cutoff,
+                         sort_budget_share(task->threads, more_size, size), ops, {0}};
+    pthread_t less_thread, more_thread;
+    int less_spawned = 0, more_spawned = 0;
+    // fall back to sorting in this thread when no more threads can be created
+    if (less_size > 1) {
+        less_spawned = pthread_create(&less_thread, NULL, multikey_task, &less) == 0;
+        if (!less_spawned) sort_serial(less.items, less_size, level, ops, stats);
+    }
+    if (more_size > 1) {
+        more_spawned = pthread_create(&more_thread, NULL, multikey_task, &more) == 0;
+        if (!more_spawned) sort_serial(more.items, more_size, level, ops, stats);
+    }
+    stats->threads_spawned += (size_t)(less_spawned + more_spawned);
+    stats->inline_sorts += (size_t)((less_size > 1 && !less_spawned) + (more_size > 1 && !more_spawned));
+
+    // this thread sorts the equal part on the next level while the others run
+    if (!equal_done && equal_size > 1) {
+        MultikeyTask equal = {items + less_size, equal_size, level + 1, task->cutoff,
+                              sort_budget_share(task->threads, equal_size, size), ops, {0}};
+        ops->load(equal.items, equal_size, equal.level, ops->context);
+        multikey_task(&equal);
+        sort_stats_add(stats, &equal.stats);
+    }
+
+    double idle_begin = timing_wall();
+    if (less_spawned) pthread_join(less_thread, NULL);
+    if (more_spawned) pthread_join(more_thread, NULL);
+    stats->idle_seconds += timing_wall() - idle_begin;
+    if (less_spawned) sort_stats_add(stats, &less.stats);
+    if (more_spawned) sort_stats_add(stats, &more.stats);
+    return NULL;
+}
+
+/**
+ * @brief Sorts items in place by their keys, level after level, in the order given by ops.
+ *
+ * The refs of items must be set; their keys are loaded for level 0 here.
+ *
+ * @param cutoff  Part size below which no more threads are started.
+ * @param threads Thread budget; 0 is unlimited and 1 sorts serially.
+ * @param stats   Receives the counters of the sort.
+ */
+void multikey_sort(MultikeyItem *items, size_t size, size_t cutoff, size_t threads, const MultikeyOps *ops,
+                   SortStats *stats) {
+    ops->load(items, size, 0, ops->context);
+    MultikeyTask root = {items, size, 0, cutoff, threads, ops, {0}};
+    multikey_task(&root);
+    *stats = root.stats;
+}
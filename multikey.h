@@ -0,0 +1,47 @@
+/*
+* @author   Jatin Jain
+* @file     multikey.h
+* @desc     parallel multikey quicksort on cached integer keys, the engine shared by string_sort() and column_sort().
+* @date     17 october 2026
+*/
+
+#ifndef MULTIKEY_H
+#define MULTIKEY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "threadedsort.h"
+
+/**
+ * @brief An element being sorted and its cached key at the current level.
+ *
+ * `ref` identifies the element to the ops (a string pointer, a row
+ * position); the sort only moves it around.
+ */
+typedef struct {
+    uintptr_t ref;
+    uint64_t key;
+} MultikeyItem;
+
+/**
+ * @brief How a multikey sort reads its elements.
+ *
+ * Keys are compared as unsigned integers, level by level: the items whose
+ * key equals the pivot's at one level are sorted on the next one. `load`
+ * fills in the keys of items at a level, `compare` orders two items that
+ * are equal before a level (insertion sort of small parts) and `last` is
+ * nonzero when items sharing a key at a level are equal, so the level after
+ * it is never loaded. `context` is passed to all three.
+ */
+typedef struct {
+    void (*load)(MultikeyItem *items, size_t size, size_t level, const void *context);
+    int (*compare)(const MultikeyItem *a, const MultikeyItem *b, size_t level, const void *context);
+    int (*last)(uint64_t key, size_t level, const void *context);
+    const void *context;
+} MultikeyOps;
+
+void multikey_sort(MultikeyItem *items, size_t size, size_t cutoff, size_t threads, const MultikeyOps *ops,
+                   SortStats *stats);
+
+#endif
@@ -0,0 +1,258 @@
+/*
+* @author   Jatin Jain
+* @file     perfctr.c
+* @desc     per-phase hardware counters. Every thread opens its own counter group on first use and reads it when a phase begins
+*           or ends; the difference goes to the innermost open phase of that thread. Totals are kept per thread and added to
+*           the report under a lock when the thread exits. Counters the CPU or kernel does not offer are reported as n/a, and
+*           when none can be opened perf_init() fails and the hooks stay no-ops.
+* @date     17 october 2026
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "perfctr.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#ifdef __NR_perf_event_open
+#define HAVE_PERF_EVENT 1
+#endif
+#endif
+#endif
+
+#define PERF_MAX_DEPTH 4                // phases open at once in one thread
+
+/**
+ * @brief Counter group and phase totals of one thread.
+ */
+typedef struct {
+    int fds[PERF_EVENT_COUNT];
+    int leader;
+    uint64_t last[PERF_EVENT_COUNT];
+    PerfPhase stack[PERF_MAX_DEPTH];
+    int depth;
+    uint64_t totals[PERF_PHASE_COUNT][PERF_EVENT_COUNT];
+    uint64_t calls[PERF_PHASE_COUNT];
+} PerfThread;
+
+static const char *phase_names[PERF_PHASE_COUNT] = {"parse", "partition", "merge", "leaf"};
+
+static int enabled;
+static unsigned available;              // bit e set if event e could be opened
+static pthread_key_t thread_key;
+static pthread_mutex_t totals_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t totals[PERF_PHASE_COUNT][PERF_EVENT_COUNT];
+static uint64_t calls[PERF_PHASE_COUNT];
+
+#ifdef HAVE_PERF_EVENT
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} events[PERF_EVENT_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+/**
+ * @brief Opens one user space counter of the calling thread, in the group of leader (or as a leader if -1).
+ */
+static int open_event(PerfEvent event, int leader) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = events[event].type;
+    attr.config = events[event].config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+#endif
+
+/**
+ * @brief Opens the counter group of the calling thread.
+ *
+ * The first event that opens leads the group; the events in `wanted` that
+ * fail are left at -1.
+ *
+ * @return The events that opened.
+ */
+static unsigned open_group(PerfThread *t, unsigned wanted) {
+    unsigned opened = 0;
+    t->leader = -1;
+    for (int e = 0; e < PERF_EVENT_COUNT; e++) {
+        t->fds[e] = -1;
+#ifdef HAVE_PERF_EVENT
+        if (!(wanted & (1u << e))) continue;
+        t->fds[e] = open_event((PerfEvent)e, t->leader);
+        if (t->fds[e] < 0) continue;
+        if (t->leader < 0) t->leader = t->fds[e];
+        opened |= 1u << e;
+#else
+        (void)wanted;
+#endif
+    }
+    return opened;
+}
+
+/**
+ * @brief Reads the counter group of a thread into values, indexed by event; missing events read 0.
+ */
+static void read_group(const PerfThread *t, uint64_t *values) {
+    uint64_t buf[1 + PERF_EVENT_COUNT];
+    memset(values, 0, PERF_EVENT_COUNT * sizeof(uint64_t));
+    if (t->leader < 0 || read(t->leader, buf, sizeof(buf)) < (ssize_t)sizeof(uint64_t)) return;
+    // the group returns its members in the order they were opened
+    uint64_t i = 0;
+    for (int e = 0; e < PERF_EVENT_COUNT && i < buf[0]; e++)
+        if (t->fds[e] >= 0) values[e] = buf[1 + i++];
+}
+
+/**
+ * @brief Adds the totals of a thread to the report and closes its counters.
+ */
+static void thread_exit(void *arg) {
+    PerfThread *t = arg;
+    pthread_mutex_lock(&totals_lock);
+    for (int p = 0; p < PERF_PHASE_COUNT; p++) {
+        calls[p] += t->calls[p];
+        for (int e = 0; e < PERF_EVENT_COUNT; e++) totals[p][e] += t->totals[p][e];
+    }
+    pthread_mutex_unlock(&totals_lock);
+    for (int e = 0; e < PERF_EVENT_COUNT; e++)
+        if (t->fds[e] >= 0) close(t->fds[e]);
+    free(t);
+}
+
+/**
+ * @brief The state of the calling thread, opened on first use. NULL if it cannot be allocated.
+ */
+static PerfThread *current_thread(void) {
+    PerfThread *t = pthread_getspecific(thread_key);
+    if (t) return t;
+    t = calloc(1, sizeof(*t));
+    if (!t) return NULL;
+    open_group(t, available);
+    read_group(t, t->last);
+    pthread_setspecific(thread_key, t);
+    return t;
+}
+
+/**
+ * @brief Charges the counts since the last reading to the innermost open phase.
+ */
+static void charge(PerfThread *t) {
+    uint64_t now[PERF_EVENT_COUNT];
+    read_group(t, now);
+    if (t->depth > 0) {
+        PerfPhase phase = t->stack[t->depth - 1];
+        for (int e = 0; e < PERF_EVENT_COUNT; e++) t->totals[phase][e] += now[e] - t->last[e];
+    }
+    memcpy(t->last, now, sizeof(now));
+}
+
+/**
+ * @brief Turns the counters on, probing which events this machine offers.
+ *
+ * @return 0 if at least one counter is available, or -1 (with a message) if none is.
+ */
+int perf_init(void) {
+    if (enabled) return 0;
+    PerfThread probe;
+    available = open_group(&probe, (1u << PERF_EVENT_COUNT) - 1);
+    for (int e = 0; e < PERF_EVENT_COUNT; e++)
+        if (probe.fds[e] >= 0) close(probe.fds[e]);
+    if (!available) {
+        fprintf(stderr, "Hardware performance counters are not available\n");
+        return -1;
+    }
+    if (pthread_key_create(&thread_key, thread_exit) != 0) {
+        fprintf(stderr, "Failed to set up performance counters\n");
+        return -1;
+    }
+    enabled = 1;
+    return 0;
+}
+
+/**
+ * @brief Enters a phase in the calling thread. A no-op unless perf_init() succeeded.
+ */
+void perf_begin(PerfPhase phase) {
+    if (!enabled) return;
+    PerfThread *t = current_thread();
+    if (!t) return;
+    // phases nested deeper than the stack are counted as part of the phase around them
+    if (t->depth < PERF_MAX_DEPTH) {
+        charge(t);
+        t->stack[t->depth] = phase;
+        t->calls[phase]++;
+    }
+    t->depth++;
+}
+
+/**
+ * @brief Leaves the phase last entered by the calling thread.
+ */
+void perf_end(PerfPhase phase) {
+    (void)phase;
+    if (!enabled) return;
+    PerfThread *t = pthread_getspecific(thread_key);
+    if (!t || t->depth == 0) return;
+    if (t->depth <= PERF_MAX_DEPTH) charge(t);
+    t->depth--;
+}
+
+/**
+ * @brief Prints one line per phase with its counts, IPC and misses per thousand instructions.
+ *
+ * Must be called once the instrumented threads have exited; the calling
+ * thread's own counts are included. Prints nothing unless perf_init() succeeded.
+ */
+void perf_print(FILE *out) {
+    if (!enabled) return;
+    PerfThread *self = pthread_getspecific(thread_key);
+    if (self) {
+        pthread_setspecific(thread_key, NULL);
+        thread_exit(self);
+    }
+
+    fprintf(out, "%-10s %10s %14s %14s %6s %10s %10s %10s\n", "Phase", "Calls", "Cycles", "Instructions", "IPC",
+            "Br MPKI", "LLC MPKI", "dTLB MPKI");
+    for (int p = 0; p < PERF_PHASE_COUNT; p++) {
+        if (!calls[p]) continue;
+        const uint64_t *v = totals[p];
+        char cells[PERF_EVENT_COUNT + 1][16];
+        int have_ins = (available & (1u << PERF_INSTRUCTIONS)) && v[PERF_INSTRUCTIONS];
+        for (int e = PERF_CYCLES; e <= PERF_INSTRUCTIONS; e++) {
+            if (available & (1u << e)) snprintf(cells[e], sizeof(cells[e]), "%llu", (unsigned long long)v[e]);
+            else strcpy(cells[e], "n/a");
+        }
+        if (have_ins && (available & (1u << PERF_CYCLES)) && v[PERF_CYCLES])
+            snprintf(cells[PERF_EVENT_COUNT], sizeof(cells[0]), "%.2f", (double)v[PERF_INSTRUCTIONS] / (double)v[PERF_CYCLES]);
+        else
+            strcpy(cells[PERF_EVENT_COUNT], "n/a");
+        for (int e = PERF_BRANCH_MISSES; e < PERF_EVENT_COUNT; e++) {
+            if (have_ins && (available & (1u << e)))
+                snprintf(cells[e], sizeof(cells[e]), "%.2f", 1000.0 * (double)v[e] / (double)v[PERF_INSTRUCTIONS]);
+            else
+                strcpy(cells[e], "n/a");
+        }
+        fprintf(out, "%-10s %10llu %14s %14s %6s %10s %10s %10s\n", phase_names[p], (unsigned long long)calls[p],
+                cells[PERF_CYCLES], cells[PERF_INSTRUCTIONS], cells[PERF_EVENT_COUNT], cells[PERF_BRANCH_MISSES],
+                cells[PERF_LLC_MISSES], cells[PERF_DTLB_MISSES]);
+    }
+}
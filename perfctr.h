@@ -0,0 +1,39 @@
+/*
+* @author   Jatin Jain
+* @file     perfctr.h
+* @desc     optional hardware performance counters (perf_event_open) per sort phase: cycles, instructions, branch, LLC and dTLB
+*           misses, reported as IPC and misses per thousand instructions.
+* @date     17 october 2026
+*/
+
+#ifndef PERFCTR_H
+#define PERFCTR_H
+
+#include <stdio.h>
+
+/**
+ * @brief Instrumented phases. Counts are exclusive: a leaf sort does not include the partitions and merges it runs.
+ */
+typedef enum {
+    PERF_PARSE,
+    PERF_PARTITION,
+    PERF_MERGE,
+    PERF_LEAF,
+    PERF_PHASE_COUNT
+} PerfPhase;
+
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_EVENT_COUNT
+} PerfEvent;
+
+int perf_init(void);
+void perf_begin(PerfPhase phase);
+void perf_end(PerfPhase phase);
+void perf_print(FILE *out);
+
+#endif
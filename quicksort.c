@@ -1,8 +1,7 @@
 /*
 * @author   Jatin Jain
 * @file     quicksort.c
-* @desc     this is the implementation of quick sort for an array of numbers read from a .txt file, the implementation compares the results and time complexity of threaded quick sort and a non=-threaded quicksort. 
-* @usage    ./quicksort [-p] <filename.txt>
+* @desc     this is the implementation of quick sort for an array of numbers, both a non-threaded quicksort and a threaded quicksort that sorts the partitions concurrently.
 * @date     6 december 2024
 */
 
@@ -11,17 +10,14 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <string.h>
-#include <time.h>
 
-//global values
-int thread_count = 0;
-pthread_mutex_t thread_count_mutex = PTHREAD_MUTEX_INITIALIZER;
+#include "quicksort.h"
+#include "memtrack.h"
+#include "perfctr.h"
+#include "trace.h"
+#include "timing.h"
 
-
-typedef struct {
-    int *data;
-    size_t size;
-} ThreadArgs;
+#define NINTHER_MIN 40                  // smallest array that takes the ninther pivot
 
 /**
  * @brief Partitions an array into three subarrays based on a pivot value.
@@ -33,7 +29,7 @@ typedef struct {
  * 
  * Memory is dynamically allocated for the resulting subarrays, and pointers
  * to these arrays are returned to the caller. It is the caller's responsibility
- * to free the allocated memory.
+ * to free the allocated memory; each array holds `size` elements.
  * 
  * @param[in] arr        Pointer to the input array of integers.
  * @param[in] size       The number of elements in the input array.
@@ -48,13 +44,17 @@ typedef struct {
  * @return int Returns 0 on success, or -1 if memory allocation fails.
  */
 int partition(int *arr,size_t size, int pivot, int **less, size_t *less_size,int **equal, size_t *equal_size, int **more, size_t *more_size) {
-    
-    int* less_arr = (int*)malloc(size * sizeof(int));
-    int* more_arr = (int*)malloc(size * sizeof(int));
-    int* equal_arr = (int*)malloc(size * sizeof(int));
+    perf_begin(PERF_PARTITION);
+    int* less_arr = (int*)memtrack_malloc(size * sizeof(int));
+    int* more_arr = (int*)memtrack_malloc(size * sizeof(int));
+    int* equal_arr = (int*)memtrack_malloc(size * sizeof(int));
 
     if(!less_arr || !more_arr || !equal_arr) {
         fprintf(stderr,"Exit Code: Failed to allocate memory");
+        memtrack_free(less_arr, size * sizeof(int));
+        memtrack_free(more_arr, size * sizeof(int));
+        memtrack_free(equal_arr, size * sizeof(int));
+        perf_end(PERF_PARTITION);
         return -1;
     }
 
@@ -71,6 +71,7 @@ int partition(int *arr,size_t size, int pivot, int **less, size_t *less_size,int
     *less_size = less_count;
     *more_size = more_count;
     *equal_size = equal_count;
+    perf_end(PERF_PARTITION);
     return 0;
 }
 
@@ -97,6 +98,7 @@ int partition(int *arr,size_t size, int pivot, int **less, size_t *less_size,int
 void merge(int *result, const int *less, size_t less_size,
                       const int *equal, size_t equal_size,
                       const int *more, size_t more_size) {
+    perf_begin(PERF_MERGE);
     size_t index = 0;
     // Copy 'less' partition
     memcpy(result + index, less, less_size * sizeof(int));
@@ -108,9 +110,85 @@ void merge(int *result, const int *less, size_t less_size,
 
     // Copy 'more' partition
     memcpy(result + index, more, more_size * sizeof(int));
+    perf_end(PERF_MERGE);
+}
+
+static int median_of_three(int a, int b, int c) {
+    if (a > b) { int t = a; a = b; b = t; }
+    if (b > c) b = c;
+    return a > b ? a : b;
+}
+
+/**
+ * @brief Picks a pivot as the median of the first, middle and last elements,
+ *        or as Tukey's ninther (the median of three medians of three samples
+ *        spread over the array) once it has at least NINTHER_MIN elements.
+ *
+ * Taking data[0] makes already sorted or reverse sorted input degrade to
+ * one level of recursion per element; the median of three keeps those
+ * inputs balanced. Organ pipe input (ascending then descending) still
+ * defeats the median of three, which the ninther handles.
+ *
+ * @param data Pointer to the array to pick the pivot from.
+ * @param size Number of elements in the array, must be greater than zero.
+ * @return The pivot value.
+ */
+int choose_pivot(const int *data, size_t size) {
+    if (size < NINTHER_MIN)
+        return median_of_three(data[0], data[size / 2], data[size - 1]);
+    // one sample from each ninth of the array, at an offset hashed from the size
+    // so that periodic input cannot alias every sample to the same value
+    size_t stride = size / 9, hash = size;
+    int samples[9];
+    for (size_t i = 0; i < 9; i++) {
+        hash = hash * 6364136223846793005u + 1442695040888963407u;
+        samples[i] = data[i * stride + (hash >> 16) % stride];
+    }
+    return median_of_three(median_of_three(samples[0], samples[1], samples[2]),
+                           median_of_three(samples[3], samples[4], samples[5]),
+                           median_of_three(samples[6], samples[7], samples[8]));
 }
 
 
+/**
+ * @brief quicksort() that also counts the elements it partitions and the bytes it allocates into stats.
+ *
+ * A nonzero descending merges the sorted parts in reverse, more before
+ * less, so the result comes out in descending order at no extra cost.
+ */
+int *quicksort_counted(size_t size, const int *data, int descending, SortStats *stats) {
+    if (size == 0) return NULL;
+
+    int pivot = choose_pivot(data, size);
+    int *less, *more, *equal;
+    size_t less_size, more_size, equal_size;
+
+    if (partition((int *)data, size, pivot, &less, &less_size,&equal,&equal_size, &more, &more_size) < 0)
+        return NULL;
+    stats->elements_partitioned += size;
+    stats->bytes_allocated += 4 * size * sizeof(int);   // three partitions and the result
+
+    int *sorted_less = quicksort_counted(less_size, less, descending, stats);
+    int *sorted_more = quicksort_counted(more_size, more, descending, stats);
+
+    int *result = memtrack_malloc(size * sizeof(int));
+    if (result && (less_size == 0 || sorted_less) && (more_size == 0 || sorted_more)) {
+        if (descending) merge(result, sorted_more, more_size, equal, equal_size, sorted_less, less_size);
+        else merge(result, sorted_less, less_size, equal, equal_size, sorted_more, more_size);
+    } else {
+        memtrack_free(result, size * sizeof(int));
+        result = NULL;
+    }
+
+    memtrack_free(less, size * sizeof(int));
+    memtrack_free(more, size * sizeof(int));
+    memtrack_free(equal, size * sizeof(int));
+    memtrack_free(sorted_less, less_size * sizeof(int));
+    memtrack_free(sorted_more, more_size * sizeof(int));
+
+    return result;
+}
+
 /**
  * @brief Performs the quicksort algorithm on an array of integers.
  *
@@ -125,29 +203,44 @@ void merge(int *result, const int *less, size_t less_size,
  *         or NULL if the input size is zero or memory allocation fails.
  */
 int *quicksort(size_t size, const int *data) {
-    if (size == 0) return NULL;
-
-    int pivot = data[0];
-    int *less, *more, *equal;
-    size_t less_size, more_size, equal_size;
-
-    if (partition((int *)data, size, pivot, &less, &less_size,&equal,&equal_size, &more, &more_size) < 0)
-        return NULL;
-
-    int *sorted_less = quicksort(less_size, less);
-    int *sorted_more = quicksort(more_size, more);
+    SortStats unused;
+    memset(&unused, 0, sizeof(unused));
+    return quicksort_counted(size, data, 0, &unused);
+}
 
-    int *result = malloc(size * sizeof(int));
-    merge(result, sorted_less, less_size, equal, equal_size, sorted_more, more_size);
-    
+/**
+ * @brief Adds the counters of part to total.
+ */
+void sort_stats_add(SortStats *total, const SortStats *part) {
+    total->tasks += part->tasks;
+    total->threads_spawned += part->threads_spawned;
+    total->inline_sorts += part->inline_sorts;
+    total->elements_partitioned += part->elements_partitioned;
+    total->bytes_allocated += part->bytes_allocated;
+    total->idle_seconds += part->idle_seconds;
+}
 
-    free(less);
-    free(more);
-    free(equal);
-    free(sorted_less);
-    free(sorted_more);
+/**
+ * @brief Share of a thread budget for a part of part_size out of size elements: at least 1, 0 if unlimited.
+ *
+ * Used by the engines that split their budget between parts by size.
+ */
+size_t sort_budget_share(size_t threads, size_t part_size, size_t size) {
+    if (threads == 0) return 0;
+    size_t share = (size_t)((double)threads * (double)part_size / (double)size);
+    return share ? share : 1;
+}
 
-    return result;
+/**
+ * @brief Prints the counters, one per line.
+ */
+void sort_stats_print(const SortStats *stats, FILE *out) {
+    fprintf(out, "Tasks:                %zu\n", stats->tasks);
+    fprintf(out, "Threads created:      %zu\n", stats->threads_spawned);
+    fprintf(out, "Inline sorts:         %zu\n", stats->inline_sorts);
+    fprintf(out, "Elements partitioned: %zu\n", stats->elements_partitioned);
+    fprintf(out, "Bytes allocated:      %zu\n", stats->bytes_allocated);
+    fprintf(out, "Idle time (s):        %f\n", stats->idle_seconds);
 }
 
 
@@ -157,193 +250,88 @@ int *quicksort(size_t size, const int *data) {
  * This function performs a parallelized quicksort using pthreads to sort subarrays concurrently. 
  * It partitions the input data into three sections: less than the pivot, equal to the pivot, and greater than the pivot.
  * The less-than and greater-than partitions are sorted in separate threads. Afterward, these partitions are merged 
- * to form the final sorted array.
+ * to form the final sorted array. Subarrays smaller than the cutoff in ThreadArgs, subarrays left with a thread
+ * budget of one, or subarrays whose thread cannot be created, are sorted with quicksort() in the current thread instead.
  *
- * @param args A pointer to a ThreadArgs structure that contains the array to sort and its size.
+ * @param args A pointer to a ThreadArgs structure that contains the array to sort, its size, the serial cutoff and
+ *             the thread budget. Its stats are overwritten with the counters of this call and all the calls below it.
  * 
  * @return A pointer to the sorted array. NULL is returned if the partition fails or the size is zero.
  */
 void* quicksort_threaded(void *args) {
-    pthread_mutex_lock(&thread_count_mutex);
-    thread_count++;
-    pthread_mutex_unlock(&thread_count_mutex);
-
     ThreadArgs *input = (ThreadArgs *)args;
     size_t size = input->size;
     int *data = input->data;
+    size_t depth = input->depth;
+    SortStats *stats = &input->stats;
+    double task_begin = trace_now();
 
+    memset(stats, 0, sizeof(*stats));
+    stats->tasks = 1;
     if (size == 0) return NULL;
+    if (size < input->cutoff || input->threads == 1) {
+        perf_begin(PERF_LEAF);
+        int *sorted = quicksort_counted(size, data, input->descending, stats);
+        perf_end(PERF_LEAF);
+        trace_span("leaf", task_begin, trace_now(), size, depth);
+        return sorted;
+    }
 
-    int pivot = data[0];
+    int pivot = choose_pivot(data, size);
     int *less, *more, *equal;
     size_t less_size, more_size, equal_size;
-    //checks if partition fails ad exits all threads.
-    if (partition(data, size, pivot, &less, &less_size,&equal, &equal_size, &more, &more_size) < 0){
-        pthread_exit(NULL);
-    }
+    // a failed partition fails this task; the parent sees the NULL and fails too, up to the root
+    if (partition(data, size, pivot, &less, &less_size,&equal, &equal_size, &more, &more_size) < 0)
+        return NULL;
+    stats->elements_partitioned += size;
+    stats->bytes_allocated += 4 * size * sizeof(int);   // three partitions and the result
+    double wait_begin = trace_now();
+    trace_span("partition", task_begin, wait_begin, size, depth);
 
-    ThreadArgs less_args = {less, less_size};
-    ThreadArgs more_args = {more, more_size};
+    size_t less_threads = input->threads / 2;
+    ThreadArgs less_args = {less, less_size, input->cutoff, less_threads, depth + 1, input->descending, {0}};
+    ThreadArgs more_args = {more, more_size, input->cutoff, input->threads - less_threads, depth + 1,
+                            input->descending, {0}};
 
     pthread_t less_thread, more_thread;
-    pthread_create(&less_thread, NULL, quicksort_threaded, &less_args);
-    pthread_create(&more_thread, NULL, quicksort_threaded, &more_args);
-
-    void *sorted_less;
-    void *sorted_more;
-    pthread_join(less_thread, &sorted_less);
-    pthread_join(more_thread, &sorted_more);
-
-    int *result = malloc(size * sizeof(int));
-    merge(result, (int *)sorted_less, less_size, equal, equal_size, (int *)sorted_more, more_size);
-    
-    free(less);
-    free(more);
-    free(equal);
-    free(sorted_less);
-    free(sorted_more);
-    return result; //returning the pointer to the result array
-}
-
-
-/** 
- * @brief Main function for sorting integers using both non-threaded and threaded quicksort.
- * 
- * This program reads integers from a file, performs non-threaded quicksort and threaded quicksort on the data, 
- * compares their execution times, and optionally prints the unsorted and sorted results if the "-p" flag is used.
- * 
- * Usage: 
- *   ./program [-p] <file_of_integers>
- * 
- * - If `-p` is provided, the program will print the unsorted and sorted lists.
- * - Reads integers from the provided input file and sorts them using two sorting methods.
- * 
- * @param argc Argument count.
- * @param argv Argument vector.
- * @return Returns 0 on successful execution, or 1 if an error occurs.
- */
-int main(int argc, char *argv[]) {
-    
-    // Validate command-line arguments
-    if (argc < 2 || argc > 3) {
-        fprintf(stderr, "Usage: %s [-p] file_of_integers\n", argv[0]);
-        return 1;
-    }
-
-    int print_flag = 0; // Flag to determine if the program should print results
-    char *filename;
-
-    // Check if the '-p' option is used
-    if (argc == 3 && strcmp(argv[1], "-p") == 0) {
-        print_flag = 1;
-        filename = argv[2];
+    void *sorted_less = NULL;
+    void *sorted_more = NULL;
+    // fall back to sorting in this thread when no more threads can be created
+    int less_spawned = pthread_create(&less_thread, NULL, quicksort_threaded, &less_args) == 0;
+    if (!less_spawned) sorted_less = quicksort_counted(less_size, less, input->descending, stats);
+    int more_spawned = pthread_create(&more_thread, NULL, quicksort_threaded, &more_args) == 0;
+    if (!more_spawned) sorted_more = quicksort_counted(more_size, more, input->descending, stats);
+    stats->threads_spawned += (size_t)(less_spawned + more_spawned);
+    stats->inline_sorts += (size_t)(!less_spawned + !more_spawned);
+
+    // each child filled in its own stats, which the join makes visible here
+    double idle_begin = timing_wall();
+    if (less_spawned) pthread_join(less_thread, &sorted_less);
+    if (more_spawned) pthread_join(more_thread, &sorted_more);
+    stats->idle_seconds += timing_wall() - idle_begin;
+    if (less_spawned) sort_stats_add(stats, &less_args.stats);
+    if (more_spawned) sort_stats_add(stats, &more_args.stats);
+    double merge_begin = trace_now();
+    trace_span("wait", wait_begin, merge_begin, size, depth);
+
+    int *result = memtrack_malloc(size * sizeof(int));
+    if (result && (less_size == 0 || sorted_less) && (more_size == 0 || sorted_more)) {
+        if (input->descending)
+            merge(result, (int *)sorted_more, more_size, equal, equal_size, (int *)sorted_less, less_size);
+        else
+            merge(result, (int *)sorted_less, less_size, equal, equal_size, (int *)sorted_more, more_size);
     } else {
-        filename = argv[1];
-    }
-
-    // Open file containing integers to sort
-    FILE *file = fopen(filename, "r");
-    if (!file) {
-        perror("Error opening file");
-        return 1;
-    }
-
-    // Dynamically allocate memory to read integers from file
-    int *data = NULL;
-    size_t size = 0, capacity = 10;
-    data = malloc(capacity * sizeof(int));
-    if (!data) {
-        perror("Memory allocation failed");
-        fclose(file);
-        return 1;
-    }
-
-    // Read integers from file into dynamically allocated array
-    while (fscanf(file, "%d", &data[size]) == 1) {
-        size++;
-        if (size == capacity) { // Resize memory when array is full
-            capacity *= 2;
-            data = realloc(data, capacity * sizeof(int));
-            if (!data) {
-                perror("Memory allocation failed");
-                fclose(file);
-                return 1;
-            }
-        }
-    }
-    fclose(file);
-
-    // Print the unsorted list if print_flag is set
-    if (print_flag) {
-        printf("Unsorted list before non-threaded quicksort: ");
-        for (size_t i = 0; i < size; i++) {
-            printf("%d", data[i]);
-            if (i < size - 1) printf(", ");
-        }
-        printf("\n");
-    }
-
-    clock_t start, end;
-
-    // Perform non-threaded quicksort and measure its execution time
-    start = clock();
-    int *sorted_non_threaded = quicksort(size, data);
-    end = clock();
-    double non_threaded_time = (double)(end - start) / CLOCKS_PER_SEC;
-    printf("Non-threaded time:  %f\n", non_threaded_time);
-
-    // Print the sorted list if print_flag is set
-    if (print_flag) {
-        printf("Resulting list: ");
-        for (size_t i = 0; i < size; i++) {
-            printf("%d", sorted_non_threaded[i]);
-            if (i < size - 1) printf(", ");
-        }
-        printf("\n");
-    }
-
-    // Print the unsorted data before threaded quicksort if print_flag is set
-    if (print_flag) {
-        printf("Unsorted list before threaded quicksort: ");
-        for (size_t i = 0; i < size; i++) {
-            printf("%d", data[i]);
-            if (i < size - 1) printf(", ");
-        }
-        printf("\n");
+        memtrack_free(result, size * sizeof(int));
+        result = NULL;
     }
-
-    // Perform threaded quicksort and measure its execution time
-    start = clock();
-    ThreadArgs args = {data, size};
-    int *sorted_threaded;
-    pthread_t main_thread;
-
-    // Start a new thread for threaded quicksort
-    pthread_create(&main_thread, NULL, quicksort_threaded, &args);
-    pthread_join(main_thread, (void **)&sorted_threaded);
-    end = clock();
-    double threaded_time = (double)(end - start) / CLOCKS_PER_SEC;
-
-    // Count number of threads spawned during the execution
-    extern int thread_count; // The global variable counting threads
-    printf("Threaded time:      %f\n", threaded_time);
-    printf("Threads spawned:    %d\n", thread_count);
-
-    // Print the sorted threaded result if the print_flag is set
-    if (print_flag) {
-        printf("Resulting list: ");
-        for (size_t i = 0; i < size; i++) {
-            printf("%d", sorted_threaded[i]);
-            if (i < size - 1) printf(", ");
-        }
-        printf("\n");
-    }
-
-    // Free dynamically allocated memory
-    free(data);
-    free(sorted_non_threaded);
-    free(sorted_threaded);
-
-    return 0;
+    
+    memtrack_free(less, size * sizeof(int));
+    memtrack_free(more, size * sizeof(int));
+    memtrack_free(equal, size * sizeof(int));
+    memtrack_free(sorted_less, less_size * sizeof(int));
+    memtrack_free(sorted_more, more_size * sizeof(int));
+    double task_end = trace_now();
+    trace_span("merge", merge_begin, task_end, size, depth);
+    trace_span("task", task_begin, task_end, size, depth);
+    return result; //returning the pointer to the result array
 }
-
@@ -0,0 +1,56 @@
+/*
+* @author   Jatin Jain
+* @file     quicksort.h
+* @desc     declarations of the in-memory quicksort engines (serial and threaded) and their partition/merge helpers,
+*           internal to libthreadedsort; programs use the sorter of threadedsort.h.
+* @date     17 october 2026
+*/
+
+#ifndef QUICKSORT_H
+#define QUICKSORT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "threadedsort.h"
+
+/**
+ * @brief Arguments handed to quicksort_threaded().
+ *
+ * `cutoff` is the subarray size below which the threaded engine stops
+ * spawning threads and finishes the subarray with the serial quicksort()
+ * in the current thread. A cutoff of 0 spawns a thread on every level.
+ * `threads` is how many threads may sort leaf subarrays at once; each level
+ * splits it between its two halves and a call with 1 sorts serially.
+ * 0 leaves the number of threads unlimited. `depth` is the recursion depth
+ * of the call, 0 for the root, and only labels trace spans. A nonzero
+ * `descending` sorts in descending order. `stats` is filled in by the call.
+ */
+typedef struct {
+    int *data;
+    size_t size;
+    size_t cutoff;
+    size_t threads;
+    size_t depth;
+    int descending;
+    SortStats stats;
+} ThreadArgs;
+
+int partition(int *arr, size_t size, int pivot, int **less, size_t *less_size,
+              int **equal, size_t *equal_size, int **more, size_t *more_size);
+
+void merge(int *result, const int *less, size_t less_size,
+                        const int *equal, size_t equal_size,
+                        const int *more, size_t more_size);
+
+int choose_pivot(const int *data, size_t size);
+
+int *quicksort(size_t size, const int *data);
+int *quicksort_counted(size_t size, const int *data, int descending, SortStats *stats);
+
+void *quicksort_threaded(void *args);
+
+void sort_stats_add(SortStats *total, const SortStats *part);
+size_t sort_budget_share(size_t threads, size_t part_size, size_t size);
+
+#endif
@@ -0,0 +1,179 @@
+/*
+* @author   Jatin Jain
+* @file     radix.c
+* @desc     parallel LSD radix sort of unsigned keys, one byte per pass. Every pass, each worker counts the digits of its
+*           own slice, works out where its slice's keys go from the counts of all workers, and scatters them into the other
+*           buffer; two barriers per pass keep the workers in step, so the threads are created once per sort. Passes whose
+*           digit is the same for every key are skipped, which makes narrow ranges (small ints, floats of one sign and
+*           magnitude) cheaper than the full key width. The sort is stable. The code is instantiated by a macro for 32 and
+*           64-bit keys, alone or as records that carry a payload moved with the key.
+* @date     17 october 2026
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "radix.h"
+#include "memtrack.h"
+
+#define RADIX_BUCKETS 256
+#define RADIX_INSERTION_MAX 64          // below this many keys, insertion sort
+#define RADIX_MIN_SLICE (1 << 16)       // keys per worker below which fewer workers are used
+
+/**
+ * @brief Number of workers for size keys with a thread budget (0 is unlimited, meaning one per core).
+ */
+static size_t radix_workers(size_t size, size_t threads) {
+    if (threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? (size_t)cores : 1;
+    }
+    size_t most = size / RADIX_MIN_SLICE;
+    if (threads > most) threads = most;
+    return threads ? threads : 1;
+}
+
+#define DEFINE_RADIX(SUFFIX, ITEM, KEY, KEY_OF)                                                                         \
+typedef struct {                                                                                                        \
+    ITEM *buffers[2];                                                                                                   \
+    size_t size;                                                                                                        \
+    size_t workers;                                                                                                     \
+    size_t (*counts)[RADIX_BUCKETS];    /* counts[worker][digit] of the current pass */                                 \
+    pthread_barrier_t barrier;                                                                                          \
+    pthread_mutex_t lock;               /* with ready, holds the workers until their number is known */                 \
+    pthread_cond_t start;                                                                                               \
+    int ready;                                                                                                          \
+} RadixJob_##SUFFIX;                                                                                                    \
+                                                                                                                        \
+typedef struct {                                                                                                        \
+    RadixJob_##SUFFIX *job;                                                                                             \
+    size_t id;                                                                                                          \
+} RadixWorker_##SUFFIX;                                                                                                 \
+                                                                                                                        \
+static void *radix_worker_##SUFFIX(void *arg) {                                                                         \
+    RadixWorker_##SUFFIX *worker = arg;                                                                                 \
+    RadixJob_##SUFFIX *job = worker->job;                                                                               \
+    pthread_mutex_lock(&job->lock);                                                                                     \
+    while (!job->ready) pthread_cond_wait(&job->start, &job->lock);                                                     \
+    pthread_mutex_unlock(&job->lock);                                                                                   \
+    size_t id = worker->id, n = job->size, w = job->workers;                                                            \
+    size_t begin = n * id / w, end = n * (id + 1) / w;                                                                  \
+    int current = 0;                                                                                                    \
+    for (unsigned shift = 0; shift < 8 * sizeof(KEY); shift += 8) {                                                     \
+        const ITEM *src = job->buffers[current];                                                                        \
+        ITEM *dst = job->buffers[1 - current];                                                                          \
+        size_t *mine = job->counts[id];                                                                                 \
+        memset(mine, 0, RADIX_BUCKETS * sizeof(size_t));                                                                \
+        for (size_t i = begin; i < end; i++) mine[(KEY_OF(src[i]) >> shift) & 0xff]++;                                  \
+        pthread_barrier_wait(&job->barrier);                                                                            \
+                                                                                                                        \
+        /* every worker reaches the same skip decision from the same counts */                                          \
+        size_t offsets[RADIX_BUCKETS], base = 0;                                                                        \
+        int skip = 0;                                                                                                   \
+        for (size_t d = 0; d < RADIX_BUCKETS; d++) {                                                                    \
+            size_t total = 0, before = 0;                                                                               \
+            for (size_t t = 0; t < w; t++) {                                                                            \
+                if (t == id) before = total;                                                                            \
+                total += job->counts[t][d];                                                                             \
+            }                                                                                                           \
+            if (total == n) skip = 1;                                                                                   \
+            offsets[d] = base + before;                                                                                 \
+            base += total;                                                                                              \
+        }                                                                                                               \
+        if (!skip) {                                                                                                    \
+            for (size_t i = begin; i < end; i++) dst[offsets[(KEY_OF(src[i]) >> shift) & 0xff]++] = src[i];             \
+            current = 1 - current;                                                                                      \
+        }                                                                                                               \
+        /* the counts are reused by the next pass */                                                                    \
+        pthread_barrier_wait(&job->barrier);                                                                            \
+    }                                                                                                                   \
+    if (current) memcpy(job->buffers[0] + begin, job->buffers[1] + begin, (end - begin) * sizeof(ITEM));                \
+    return NULL;                                                                                                        \
+}                                                                                                                       \
+                                                                                                                        \
+/**                                                                                                                     \
+ * @brief Sorts size items in place by key with up to threads workers (0 is one per core). Items with equal keys        \
+ *        keep their order.                                                                                             \
+ *                                                                                                                      \
+ * Threads that cannot be created leave their share to the others.                                                      \
+ *                                                                                                                      \
+ * @return 0 on success, or -1 if the scratch buffer cannot be allocated; items are then unchanged.                     \
+ */                                                                                                                     \
+int radix_sort_##SUFFIX(ITEM *items, size_t size, size_t threads, SortStats *stats) {                                   \
+    stats->tasks = 1;                                                                                                   \
+    if (size <= RADIX_INSERTION_MAX) {                                                                                  \
+        for (size_t i = 1; i < size; i++) {                                                                             \
+            ITEM item = items[i];                                                                                       \
+            size_t j = i;                                                                                               \
+            for (; j > 0 && KEY_OF(items[j - 1]) > KEY_OF(item); j--) items[j] = items[j - 1];                          \
+            items[j] = item;                                                                                            \
+        }                                                                                                               \
+        return 0;                                                                                                       \
+    }                                                                                                                   \
+                                                                                                                        \
+    RadixJob_##SUFFIX job;                                                                                              \
+    job.size = size;                                                                                                    \
+    job.workers = radix_workers(size, threads);                                                                         \
+    job.buffers[0] = items;                                                                                             \
+    job.buffers[1] = memtrack_malloc(size * sizeof(ITEM));                                                              \
+    job.counts = malloc(job.workers * sizeof(*job.counts));                                                             \
+    RadixWorker_##SUFFIX *workers = malloc(job.workers * sizeof(*workers));                                             \
+    pthread_t *handles = malloc(job.workers * sizeof(*handles));                                                        \
+    if (!job.buffers[1] || !job.counts || !workers || !handles) {                                                       \
+        fprintf(stderr, "Failed to set up the radix sort\n");                                                           \
+        memtrack_free(job.buffers[1], size * sizeof(ITEM));                                                             \
+        free(job.counts);                                                                                               \
+        free(workers);                                                                                                  \
+        free(handles);                                                                                                  \
+        return -1;                                                                                                      \
+    }                                                                                                                   \
+    stats->bytes_allocated += size * sizeof(ITEM);                                                                      \
+                                                                                                                        \
+    /* the workers wait at the gate until they know how many threads could be created; the caller is worker 0 */        \
+    pthread_mutex_init(&job.lock, NULL);                                                                                \
+    pthread_cond_init(&job.start, NULL);                                                                                \
+    job.ready = 0;                                                                                                      \
+    size_t started = 1;                                                                                                 \
+    for (size_t t = 0; t < job.workers; t++) {                                                                          \
+        workers[t].job = &job;                                                                                          \
+        workers[t].id = t;                                                                                              \
+    }                                                                                                                   \
+    for (; started < job.workers; started++)                                                                            \
+        if (pthread_create(&handles[started], NULL, radix_worker_##SUFFIX, &workers[started]) != 0) break;              \
+    job.workers = started;                                                                                              \
+    pthread_barrier_init(&job.barrier, NULL, (unsigned)job.workers);                                                    \
+    pthread_mutex_lock(&job.lock);                                                                                      \
+    job.ready = 1;                                                                                                      \
+    pthread_cond_broadcast(&job.start);                                                                                 \
+    pthread_mutex_unlock(&job.lock);                                                                                    \
+    radix_worker_##SUFFIX(&workers[0]);                                                                                 \
+    for (size_t t = 1; t < started; t++) pthread_join(handles[t], NULL);                                                \
+    stats->tasks = job.workers;                                                                                         \
+    stats->threads_spawned = started - 1;                                                                               \
+                                                                                                                        \
+    pthread_barrier_destroy(&job.barrier);                                                                              \
+    pthread_cond_destroy(&job.start);                                                                                   \
+    pthread_mutex_destroy(&job.lock);                                                                                   \
+    memtrack_free(job.buffers[1], size * sizeof(ITEM));                                                                 \
+    free(job.counts);                                                                                                   \
+    free(workers);                                                                                                      \
+    free(handles);                                                                                                      \
+    return 0;                                                                                                           \
+}
+
+#define PLAIN_KEY(item) (item)
+#define RECORD_KEY(item) ((item).key)
+
+DEFINE_RADIX(u32, uint32_t, uint32_t, PLAIN_KEY)
+DEFINE_RADIX(u64, uint64_t, uint64_t, PLAIN_KEY)
+DEFINE_RADIX(r32x4, RadixRecord32x4, uint32_t, RECORD_KEY)
+DEFINE_RADIX(r32x8, RadixRecord32x8, uint32_t, RECORD_KEY)
+DEFINE_RADIX(r32x16, RadixRecord32x16, uint32_t, RECORD_KEY)
+DEFINE_RADIX(r64x4, RadixRecord64x4, uint64_t, RECORD_KEY)
+DEFINE_RADIX(r64x8, RadixRecord64x8, uint64_t, RECORD_KEY)
+DEFINE_RADIX(r64x16, RadixRecord64x16, uint64_t, RECORD_KEY)
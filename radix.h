@@ -0,0 +1,36 @@
+/*
+* @author   Jatin Jain
+* @file     radix.h
+* @desc     parallel LSD radix sort of unsigned 32 and 64-bit keys, alone or with a 4, 8 or 16-byte payload, the engine
+*           behind the typed and record sorts of threadedsort.h.
+* @date     17 october 2026
+*/
+
+#ifndef RADIX_H
+#define RADIX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "threadedsort.h"
+
+/*
+ * Records: an unsigned key and a payload that is moved with it.
+ */
+typedef struct { uint32_t key; unsigned char payload[4]; } RadixRecord32x4;
+typedef struct { uint32_t key; unsigned char payload[8]; } RadixRecord32x8;
+typedef struct { uint32_t key; unsigned char payload[16]; } RadixRecord32x16;
+typedef struct { uint64_t key; unsigned char payload[4]; } RadixRecord64x4;
+typedef struct { uint64_t key; unsigned char payload[8]; } RadixRecord64x8;
+typedef struct { uint64_t key; unsigned char payload[16]; } RadixRecord64x16;
+
+int radix_sort_u32(uint32_t *keys, size_t size, size_t threads, SortStats *stats);
+int radix_sort_u64(uint64_t *keys, size_t size, size_t threads, SortStats *stats);
+int radix_sort_r32x4(RadixRecord32x4 *items, size_t size, size_t threads, SortStats *stats);
+int radix_sort_r32x8(RadixRecord32x8 *items, size_t size, size_t threads, SortStats *stats);
+int radix_sort_r32x16(RadixRecord32x16 *items, size_t size, size_t threads, SortStats *stats);
+int radix_sort_r64x4(RadixRecord64x4 *items, size_t size, size_t threads, SortStats *stats);
+int radix_sort_r64x8(RadixRecord64x8 *items, size_t size, size_t threads, SortStats *stats);
+int radix_sort_r64x16(RadixRecord64x16 *items, size_t size, size_t threads, SortStats *stats);
+
+#endif
@@ -0,0 +1,191 @@
+/*
+* @author   Jatin Jain
+* @file     runcodec.c
+* @desc     delta + bit-packing codec for sorted runs. A block holds up to 128 ints as its first value and the 128 differences
+*           between neighbours, all packed with the bit width of the largest difference. The differences are packed in four
+*           interleaved 32-bit lanes (difference i goes to lane i % 4), so one 128-bit load feeds four values and the decoder
+*           unpacks and prefix-sums four at a time with SSE2. Other targets use the scalar decoder, which reads the same format.
+* @date     17 october 2026
+*/
+
+#include <string.h>
+
+#include "runcodec.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @brief Upper bound on the bytes run_encode() writes for count ints.
+ */
+size_t run_encode_bound(size_t count) {
+    return (count + RUN_BLOCK - 1) / RUN_BLOCK * RUN_BLOCK_MAX_BYTES;
+}
+
+/**
+ * @brief Nonzero if an 8-byte block header is one run_encode_block() can write: 1 to RUN_BLOCK ints of at most 32 bits.
+ *
+ * run_block_size() and run_decode_block() trust the header, so a header read
+ * back from a file must pass this first.
+ */
+int run_block_valid(const unsigned char *header) {
+    uint16_t count;
+    memcpy(&count, header, 2);
+    return count >= 1 && count <= RUN_BLOCK && header[2] <= 32;
+}
+
+/**
+ * @brief Total size in bytes of the block whose 8-byte header is given.
+ */
+size_t run_block_size(const unsigned char *header) {
+    return RUN_BLOCK_HEADER + (size_t)header[2] * (RUN_BLOCK / 8);
+}
+
+/**
+ * @brief Encodes up to RUN_BLOCK ints as one block.
+ *
+ * The differences are taken modulo 2^32, so any sequence round-trips; sorted
+ * runs with small gaps get a small bit width.
+ *
+ * @param[in]  values The ints to encode.
+ * @param[in]  count  Number of ints, 1 to RUN_BLOCK.
+ * @param[out] out    Receives the block, at most RUN_BLOCK_MAX_BYTES.
+ * @return Number of bytes written.
+ */
+size_t run_encode_block(const int *values, size_t count, unsigned char *out) {
+    uint32_t deltas[RUN_BLOCK];
+    uint32_t used = 0;
+    deltas[0] = 0;
+    for (size_t i = 1; i < count; i++) {
+        deltas[i] = (uint32_t)values[i] - (uint32_t)values[i - 1];
+        used |= deltas[i];
+    }
+    for (size_t i = count; i < RUN_BLOCK; i++) deltas[i] = 0;
+
+    unsigned bits = 0;
+    while (bits < 32 && (used >> bits)) bits++;
+
+    uint16_t n = (uint16_t)count;
+    memcpy(out, &n, 2);
+    out[2] = (unsigned char)bits;
+    out[3] = 0;
+    memcpy(out + 4, &values[0], 4);
+
+    // lane l packs deltas l, l + 4, l + 8, ... into words l, l + 4, l + 8, ...
+    uint32_t words[RUN_BLOCK];
+    memset(words, 0, bits * 4 * sizeof(uint32_t));
+    for (unsigned lane = 0; lane < 4; lane++) {
+        unsigned word = 0, bit = 0;
+        for (unsigned k = 0; k < RUN_BLOCK / 4; k++) {
+            uint32_t d = deltas[4 * k + lane];
+            words[4 * word + lane] |= d << bit;
+            if (bit + bits > 32) {
+                words[4 * (word + 1) + lane] |= d >> (32 - bit);
+            }
+            bit += bits;
+            if (bit >= 32) {
+                bit -= 32;
+                word++;
+            }
+        }
+    }
+    memcpy(out + RUN_BLOCK_HEADER, words, bits * 4 * sizeof(uint32_t));
+    return RUN_BLOCK_HEADER + bits * 4 * sizeof(uint32_t);
+}
+
+/**
+ * @brief Encodes count ints as consecutive blocks.
+ *
+ * @param[in]  values The ints to encode.
+ * @param[in]  count  Number of ints.
+ * @param[out] out    Receives the blocks, at least run_encode_bound(count) bytes.
+ * @return Number of bytes written.
+ */
+size_t run_encode(const int *values, size_t count, unsigned char *out) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i += RUN_BLOCK) {
+        size_t n = count - i < RUN_BLOCK ? count - i : RUN_BLOCK;
+        bytes += run_encode_block(values + i, n, out + bytes);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Decodes one block.
+ *
+ * @param[in]  in  The block, run_block_size(in) bytes.
+ * @param[out] out Receives the ints; must have room for RUN_BLOCK.
+ * @return Number of ints in the block.
+ */
+size_t run_decode_block(const unsigned char *in, int *out) {
+    uint16_t count;
+    int32_t base;
+    memcpy(&count, in, 2);
+    unsigned bits = in[2];
+    memcpy(&base, in + 4, 4);
+    const unsigned char *packed = in + RUN_BLOCK_HEADER;
+
+#if defined(__SSE2__)
+    __m128i *dst = (__m128i *)out;
+    if (bits == 0) {
+        __m128i v = _mm_set1_epi32(base);
+        for (unsigned k = 0; k < RUN_BLOCK / 4; k++) _mm_storeu_si128(dst + k, v);
+        return count;
+    }
+    const __m128i mask = _mm_set1_epi32(bits == 32 ? -1 : (int)((1u << bits) - 1));
+    const __m128i *src = (const __m128i *)packed;
+    __m128i word = _mm_loadu_si128(src++);
+    __m128i running = _mm_set1_epi32(base);
+    unsigned bit = 0;
+    for (unsigned k = 0; k < RUN_BLOCK / 4; k++) {
+        if (bit == 32) {
+            word = _mm_loadu_si128(src++);
+            bit = 0;
+        }
+        __m128i v = _mm_srl_epi32(word, _mm_cvtsi32_si128((int)bit));
+        if (bit + bits > 32) {
+            word = _mm_loadu_si128(src++);
+            v = _mm_or_si128(v, _mm_sll_epi32(word, _mm_cvtsi32_si128((int)(32 - bit))));
+            bit = bit + bits - 32;
+        } else {
+            bit += bits;
+        }
+        v = _mm_and_si128(v, mask);
+
+        // inclusive prefix sum of the four deltas, carried on from the previous four values
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, running);
+        _mm_storeu_si128(dst + k, v);
+        running = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+#else
+    uint32_t words[RUN_BLOCK];
+    memcpy(words, packed, bits * 4 * sizeof(uint32_t));
+    uint32_t mask = bits == 32 ? 0xffffffffu : (1u << bits) - 1;
+    uint32_t deltas[RUN_BLOCK];
+    for (unsigned lane = 0; lane < 4; lane++) {
+        unsigned word = 0, bit = 0;
+        for (unsigned k = 0; k < RUN_BLOCK / 4; k++) {
+            uint32_t d = 0;
+            if (bits) {
+                d = words[4 * word + lane] >> bit;
+                if (bit + bits > 32) d |= words[4 * (word + 1) + lane] << (32 - bit);
+            }
+            deltas[4 * k + lane] = d & mask;
+            bit += bits;
+            if (bit >= 32) {
+                bit -= 32;
+                word++;
+            }
+        }
+    }
+    uint32_t value = (uint32_t)base;
+    for (unsigned i = 0; i < RUN_BLOCK; i++) {
+        value += deltas[i];
+        out[i] = (int)value;
+    }
+#endif
+    return count;
+}
@@ -0,0 +1,26 @@
+/*
+* @author   Jatin Jain
+* @file     runcodec.h
+* @desc     compressed format of the external sort's run files: blocks of 128 ints stored as a base value and bit-packed deltas.
+* @date     17 october 2026
+*/
+
+#ifndef RUNCODEC_H
+#define RUNCODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RUN_BLOCK           128         // ints per block
+#define RUN_BLOCK_HEADER    8           // count (2 bytes), bit width (1), unused (1), base value (4)
+#define RUN_BLOCK_MAX_BYTES (RUN_BLOCK_HEADER + RUN_BLOCK * 4)
+
+size_t run_encode_bound(size_t count);
+size_t run_encode_block(const int *values, size_t count, unsigned char *out);
+size_t run_encode(const int *values, size_t count, unsigned char *out);
+
+int run_block_valid(const unsigned char *header);
+size_t run_block_size(const unsigned char *header);
+size_t run_decode_block(const unsigned char *in, int *out);
+
+#endif
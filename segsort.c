@@ -0,0 +1,219 @@
+/*
+* @author   Jatin Jain
+* @file     segsort.c
+* @desc     segmented sort: sorts every segment of a values array, given as offsets, in place and independently. The
+*           segments are dealt out to workers in contiguous runs of about equal element counts, found by binary search on
+*           the offsets, and each segment is sorted by a kernel picked by its size: a sorting network up to 8 elements,
+*           insertion sort up to 32, and an in-place quicksort above. No kernel allocates, so a segment costs no more than
+*           its comparisons. A macro instantiates the kernels once per direction.
+* @date     17 october 2026
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "segsort.h"
+#include "quicksort.h"
+#include "timing.h"
+
+#define SEGMENT_NETWORK_MAX 8           // at most this many elements, sorting network
+#define SEGMENT_INSERTION_MAX 32        // at most this many elements, insertion sort
+#define SEGMENT_MIN_SLICE (1 << 16)     // elements per worker below which fewer workers are used
+
+/**
+ * @brief A run of segments sorted by one worker.
+ */
+typedef struct {
+    int *values;
+    const size_t *offsets;
+    size_t first;
+    size_t last;                        // one past the last segment
+    int descending;
+    SortStats stats;
+} SegmentWorker;
+
+/*
+ * Defines the kernels sort_segment_SUFFIX() for the order in which a sorts
+ * before b when BEFORE(a, b); PAD sorts after every value and fills the
+ * network's unused inputs.
+ */
+#define DEFINE_SEGMENT_KERNELS(SUFFIX, BEFORE, PAD)                                                                     \
+static inline void exchange_##SUFFIX(int *v, int i, int j) {                                                            \
+    int a = v[i], b = v[j];                                                                                             \
+    int swap = BEFORE(b, a);                                                                                            \
+    v[i] = swap ? b : a;                                                                                                \
+    v[j] = swap ? a : b;                                                                                                \
+}                                                                                                                       \
+                                                                                                                        \
+/* the 19-comparator network for 8 inputs, branch free */                                                              \
+static void network_##SUFFIX(int *data, size_t size) {                                                                  \
+    int v[SEGMENT_NETWORK_MAX];                                                                                         \
+    for (size_t i = 0; i < SEGMENT_NETWORK_MAX; i++) v[i] = i < size ? data[i] : PAD;                                   \
+    exchange_##SUFFIX(v, 0, 2); exchange_##SUFFIX(v, 1, 3); exchange_##SUFFIX(v, 4, 6); exchange_##SUFFIX(v, 5, 7);     \
+    exchange_##SUFFIX(v, 0, 4); exchange_##SUFFIX(v, 1, 5); exchange_##SUFFIX(v, 2, 6); exchange_##SUFFIX(v, 3, 7);     \
+    exchange_##SUFFIX(v, 0, 1); exchange_##SUFFIX(v, 2, 3); exchange_##SUFFIX(v, 4, 5); exchange_##SUFFIX(v, 6, 7);     \
+    exchange_##SUFFIX(v, 2, 4); exchange_##SUFFIX(v, 3, 5);                                                             \
+    exchange_##SUFFIX(v, 1, 4); exchange_##SUFFIX(v, 3, 6);                                                             \
+    exchange_##SUFFIX(v, 1, 2); exchange_##SUFFIX(v, 3, 4); exchange_##SUFFIX(v, 5, 6);                                 \
+    memcpy(data, v, size * sizeof(int));                                                                                \
+}                                                                                                                       \
+                                                                                                                        \
+static void insertion_##SUFFIX(int *data, size_t size) {                                                                \
+    for (size_t i = 1; i < size; i++) {                                                                                 \
+        int value = data[i];                                                                                            \
+        size_t j = i;                                                                                                   \
+        for (; j > 0 && BEFORE(value, data[j - 1]); j--) data[j] = data[j - 1];                                         \
+        data[j] = value;                                                                                                \
+    }                                                                                                                   \
+}                                                                                                                       \
+                                                                                                                        \
+/* in-place three-way quicksort around choose_pivot(), recursing into the smaller part */                              \
+static void quicksort_##SUFFIX(int *data, size_t size, SortStats *stats) {                                              \
+    while (size > SEGMENT_INSERTION_MAX) {                                                                              \
+        int pivot = choose_pivot(data, size);                                                                           \
+        size_t lt = 0, i = 0, gt = size;                                                                                \
+        while (i < gt) {                                                                                                \
+            int value = data[i];                                                                                        \
+            if (BEFORE(value, pivot)) {                                                                                 \
+                data[i++] = data[lt];                                                                                   \
+                data[lt++] = value;                                                                                     \
+            } else if (BEFORE(pivot, value)) {                                                                          \
+                data[i] = data[--gt];                                                                                   \
+                data[gt] = value;                                                                                       \
+            } else {                                                                                                    \
+                i++;                                                                                                    \
+            }                                                                                                           \
+        }                                                                                                               \
+        stats->elements_partitioned += size;                                                                            \
+        if (lt < size - gt) {                                                                                           \
+            quicksort_##SUFFIX(data, lt, stats);                                                                        \
+            data += gt;                                                                                                 \
+            size -= gt;                                                                                                 \
+        } else {                                                                                                        \
+            quicksort_##SUFFIX(data + gt, size - gt, stats);                                                            \
+            size = lt;                                                                                                  \
+        }                                                                                                               \
+    }                                                                                                                   \
+    insertion_##SUFFIX(data, size);                                                                                     \
+}                                                                                                                       \
+                                                                                                                        \
+static void sort_segment_##SUFFIX(int *data, size_t size, SortStats *stats) {                                          \
+    if (size <= SEGMENT_NETWORK_MAX) network_##SUFFIX(data, size);                                                      \
+    else if (size <= SEGMENT_INSERTION_MAX) insertion_##SUFFIX(data, size);                                             \
+    else quicksort_##SUFFIX(data, size, stats);                                                                         \
+}
+
+#define ASCENDING_BEFORE(a, b) ((a) < (b))
+#define DESCENDING_BEFORE(a, b) ((a) > (b))
+
+DEFINE_SEGMENT_KERNELS(ascending, ASCENDING_BEFORE, INT_MAX)
+DEFINE_SEGMENT_KERNELS(descending, DESCENDING_BEFORE, INT_MIN)
+
+/**
+ * @brief Thread body: sorts the segments of a SegmentWorker, filling in its stats.
+ */
+static void *segment_worker(void *arg) {
+    SegmentWorker *worker = arg;
+    const size_t *offsets = worker->offsets;
+    memset(&worker->stats, 0, sizeof(worker->stats));
+    worker->stats.tasks = 1;
+    for (size_t s = worker->first; s < worker->last; s++) {
+        int *data = worker->values + offsets[s];
+        size_t size = offsets[s + 1] - offsets[s];
+        if (worker->descending) sort_segment_descending(data, size, &worker->stats);
+        else sort_segment_ascending(data, size, &worker->stats);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Number of workers for size elements with a thread budget (0 is unlimited, meaning one per core).
+ */
+static size_t segment_workers(size_t size, size_t threads) {
+    if (threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? (size_t)cores : 1;
+    }
+    size_t most = size / SEGMENT_MIN_SLICE;
+    if (threads > most) threads = most;
+    return threads ? threads : 1;
+}
+
+/**
+ * @brief The first segment that starts at or after element target, or segment_count if none does.
+ */
+static size_t first_segment_from(const size_t *offsets, size_t segment_count, size_t target) {
+    size_t lo = 0, hi = segment_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (offsets[mid] < target) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Sorts each segment values[offsets[s]] .. values[offsets[s + 1] - 1] in place, independently of the others.
+ *
+ * @param offsets       segment_count + 1 nondecreasing positions in values.
+ * @param descending    Nonzero to sort every segment in descending order.
+ * @param threads       Thread budget; 0 is one worker per core and 1 sorts serially.
+ * @param stats         Receives the counters of the sort.
+ * @return 0 on success, or -1 if the workers cannot be set up; values are then unchanged.
+ */
+int segment_sort(int *values, const size_t *offsets, size_t segment_count, int descending, size_t threads,
+                 SortStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (segment_count == 0) return 0;
+    size_t begin = offsets[0], total = offsets[segment_count] - begin;
+    size_t count = segment_workers(total, threads);
+    SegmentWorker *workers = malloc(count * sizeof(*workers));
+    pthread_t *handles = malloc(count * sizeof(*handles));
+    int *spawned = calloc(count, sizeof(*spawned));
+    if (!workers || !handles || !spawned) {
+        fprintf(stderr, "Failed to set up the segmented sort\n");
+        free(workers);
+        free(handles);
+        free(spawned);
+        return -1;
+    }
+
+    // worker w starts at the first segment from element w * total / count, so a long segment stays with one worker
+    for (size_t w = 0; w < count; w++) {
+        size_t target = begin + (size_t)((double)total * (double)w / (double)count);
+        workers[w].values = values;
+        workers[w].offsets = offsets;
+        workers[w].first = w == 0 ? 0 : first_segment_from(offsets, segment_count, target);
+        workers[w].descending = descending;
+    }
+    for (size_t w = 0; w < count; w++) workers[w].last = w + 1 < count ? workers[w + 1].first : segment_count;
+
+    // the caller is worker 0, and runs the runs of workers that cannot be started too
+    for (size_t w = 1; w < count; w++) {
+        spawned[w] = pthread_create(&handles[w], NULL, segment_worker, &workers[w]) == 0;
+        stats->threads_spawned += (size_t)spawned[w];
+        stats->inline_sorts += (size_t)!spawned[w];
+    }
+    for (size_t w = 0; w < count; w++) {
+        if (spawned[w]) continue;
+        segment_worker(&workers[w]);
+        sort_stats_add(stats, &workers[w].stats);
+    }
+    double idle_begin = timing_wall();
+    for (size_t w = 1; w < count; w++)
+        if (spawned[w]) pthread_join(handles[w], NULL);
+    stats->idle_seconds += timing_wall() - idle_begin;
+    for (size_t w = 1; w < count; w++)
+        if (spawned[w]) sort_stats_add(stats, &workers[w].stats);
+
+    free(workers);
+    free(handles);
+    free(spawned);
+    return 0;
+}
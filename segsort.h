@@ -0,0 +1,18 @@
+/*
+* @author   Jatin Jain
+* @file     segsort.h
+* @desc     batched sort of many independent int segments of one array, the engine behind sorter_sort_segments().
+* @date     17 october 2026
+*/
+
+#ifndef SEGSORT_H
+#define SEGSORT_H
+
+#include <stddef.h>
+
+#include "threadedsort.h"
+
+int segment_sort(int *values, const size_t *offsets, size_t segment_count, int descending, size_t threads,
+                 SortStats *stats);
+
+#endif
@@ -0,0 +1,212 @@
+/*
+* @author   Jatin Jain
+* @file     selection.c
+* @desc     multi-rank selection on partition(). A task holds a range of the sorted order (as candidates whose positions
+*           start at an offset) and the ascending ranks that fall in it. It partitions the candidates, answers the ranks
+*           that land in the equal part with the pivot, frees the parts that hold no rank and carries on into the parts
+*           that do, the less part in a new thread when both have ranks, so many ranks are answered in one pass that
+*           only descends where they are. A range holding a single rank picks its pivot from a sorted sample, a little
+*           past the rank on the side away from the nearer end (after Floyd and Rivest), so the part that keeps the rank
+*           is small. Small ranges are sorted outright.
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#include "selection.h"
+#include "quicksort.h"
+#include "memtrack.h"
+#include "timing.h"
+
+#define SELECT_SORT_MAX 64              // ranges of at most this many candidates are sorted
+#define SELECT_SAMPLE_MIN (1 << 14)     // smallest single-rank range that takes a sampled pivot
+
+/**
+ * @brief Arguments of one selection task, like ThreadArgs.
+ *
+ * `data` holds the `size` candidates at positions `offset` to
+ * `offset + size - 1` of the sorted order, in no order. It was allocated
+ * by partition() with `owned_size` elements, or is the input if
+ * `owned_size` is 0. `ranks` are the ascending positions to find in it and
+ * `values` receives their elements. `status` is -1 if the task or one
+ * below it ran out of memory.
+ */
+typedef struct {
+    const int *data;
+    size_t size;
+    size_t owned_size;
+    size_t offset;
+    const size_t *ranks;
+    int *values;
+    size_t rank_count;
+    size_t cutoff;
+    size_t threads;
+    int status;
+    SortStats stats;
+} SelectTask;
+
+static void release(const int *data, size_t owned_size) {
+    if (owned_size) memtrack_free((int *)data, owned_size * sizeof(int));
+}
+
+/**
+ * @brief Pivot for a range of size candidates that holds only the given rank (counted from the range's start).
+ *
+ * About 4 sqrt(size) candidates are sampled and sorted; the pivot is the
+ * sample at the rank's relative position, moved sqrt(samples) samples
+ * toward the middle. The rank then most likely falls in the part on the
+ * near side of the pivot, which holds little more than the distance from
+ * the rank to the range's end. Falls back to choose_pivot() if the sample
+ * cannot be sorted.
+ */
+static int sampled_pivot(const int *data, size_t size, size_t rank, SortStats *stats) {
+    size_t samples = 4 * (size_t)sqrt((double)size), stride = size / samples, hash = size;
+    int *sample = memtrack_malloc(samples * sizeof(int));
+    if (!sample) return choose_pivot(data, size);
+    for (size_t i = 0; i < samples; i++) {
+        hash = hash * 6364136223846793005u + 1442695040888963407u;
+        sample[i] = data[i * stride + (hash >> 16) % stride];
+    }
+    int *sorted = quicksort_counted(samples, sample, 0, stats);
+    memtrack_free(sample, samples * sizeof(int));
+    if (!sorted) return choose_pivot(data, size);
+
+    size_t at = (size_t)((double)rank * (double)samples / (double)size), gap = (size_t)sqrt((double)samples);
+    if (rank < size / 2) at = at + gap < samples ? at + gap : samples - 1;
+    else at = at > gap ? at - gap : 0;
+    int pivot = sorted[at];
+    memtrack_free(sorted, samples * sizeof(int));
+    return pivot;
+}
+
+/**
+ * @brief Number of the rank_count ascending ranks below limit.
+ */
+static size_t ranks_below(const size_t *ranks, size_t rank_count, size_t limit) {
+    size_t lo = 0, hi = rank_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ranks[mid] < limit) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/**
+ * @brief Thread body: answers the ranks of a SelectTask, filling in its stats and status and freeing its data.
+ */
+static void *select_task(void *arg) {
+    SelectTask *task = arg;
+    SortStats *stats = &task->stats;
+    memset(stats, 0, sizeof(*stats));
+    stats->tasks = 1;
+    task->status = 0;
+    const int *data = task->data;
+    size_t size = task->size, owned_size = task->owned_size, offset = task->offset, rank_count = task->rank_count;
+    const size_t *ranks = task->ranks;
+    int *values = task->values;
+
+    // a range that keeps one part loops here; when both parts hold ranks the less part becomes a task of its own
+    while (rank_count > 0) {
+        if (size <= SELECT_SORT_MAX) {
+            int *sorted = quicksort_counted(size, data, 0, stats);
+            if (!sorted) {
+                task->status = -1;
+                break;
+            }
+            for (size_t r = 0; r < rank_count; r++) values[r] = sorted[ranks[r] - offset];
+            memtrack_free(sorted, size * sizeof(int));
+            break;
+        }
+
+        int pivot = rank_count == 1 && size >= SELECT_SAMPLE_MIN ? sampled_pivot(data, size, ranks[0] - offset, stats)
+                                                                 : choose_pivot(data, size);
+        int *less, *equal, *more;
+        size_t less_size, equal_size, more_size;
+        if (partition((int *)data, size, pivot, &less, &less_size, &equal, &equal_size, &more, &more_size) < 0) {
+            task->status = -1;
+            break;
+        }
+        stats->elements_partitioned += size;
+        stats->bytes_allocated += 3 * size * sizeof(int);
+        release(data, owned_size);
+        memtrack_free(equal, size * sizeof(int));
+
+        size_t in_less = ranks_below(ranks, rank_count, offset + less_size);
+        size_t in_equal = ranks_below(ranks, rank_count, offset + less_size + equal_size) - in_less;
+        size_t in_more = rank_count - in_less - in_equal;
+        for (size_t r = in_less; r < in_less + in_equal; r++) values[r] = pivot;
+        if (in_less == 0) memtrack_free(less, size * sizeof(int));
+        if (in_more == 0) memtrack_free(more, size * sizeof(int));
+
+        if (in_less > 0 && in_more > 0) {
+            SelectTask lower = {less, less_size, size, offset, ranks, values, in_less, task->cutoff,
+                                sort_budget_share(task->threads, less_size, size), 0, {0}};
+            pthread_t lower_thread;
+            int spawned = 0;
+            if (size >= task->cutoff && task->threads != 1) {
+                spawned = pthread_create(&lower_thread, NULL, select_task, &lower) == 0;
+                stats->threads_spawned += (size_t)spawned;
+                stats->inline_sorts += (size_t)!spawned;
+            }
+            if (spawned) {
+                // this thread answers the more part while the less part runs
+                SelectTask upper = {more, more_size, size, offset + less_size + equal_size, ranks + in_less + in_equal,
+                                    values + in_less + in_equal, in_more, task->cutoff,
+                                    sort_budget_share(task->threads, more_size, size), 0, {0}};
+                select_task(&upper);
+                sort_stats_add(stats, &upper.stats);
+                double idle_begin = timing_wall();
+                pthread_join(lower_thread, NULL);
+                stats->idle_seconds += timing_wall() - idle_begin;
+                sort_stats_add(stats, &lower.stats);
+                if (upper.status < 0 || lower.status < 0) task->status = -1;
+                return NULL;
+            }
+            select_task(&lower);
+            sort_stats_add(stats, &lower.stats);
+            if (lower.status < 0) task->status = -1;
+        }
+        owned_size = size;
+        if (in_more > 0) {
+            data = more;
+            offset += less_size + equal_size;
+            ranks += in_less + in_equal;
+            values += in_less + in_equal;
+            size = more_size;
+            rank_count = in_more;
+        } else if (in_less > 0) {
+            data = less;
+            size = less_size;
+            rank_count = in_less;
+        } else {
+            data = NULL;
+            owned_size = 0;
+            rank_count = 0;
+        }
+    }
+    release(data, owned_size);
+    return NULL;
+}
+
+/**
+ * @brief Finds the elements at several positions of the ascending sorted order of data, without sorting it.
+ *
+ * @param ranks      rank_count ascending positions, each below size.
+ * @param[out] values The element at each rank.
+ * @param cutoff     Range size below which no more threads are started.
+ * @param threads    Thread budget; 0 is unlimited and 1 selects serially.
+ * @param stats      Receives the counters of the selection.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int select_ranks(const int *data, size_t size, const size_t *ranks, size_t rank_count, int *values, size_t cutoff,
+                 size_t threads, SortStats *stats) {
+    SelectTask root = {data, size, 0, 0, ranks, values, rank_count, cutoff, threads, 0, {0}};
+    select_task(&root);
+    *stats = root.stats;
+    return root.status;
+}
@@ -0,0 +1,19 @@
+/*
+* @author   Jatin Jain
+* @file     selection.h
+* @desc     parallel multi-rank selection (nth element) of an int array, the engine behind sorter_select() and
+*           sorter_quantiles().
+* @date     17 october 2026
+*/
+
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <stddef.h>
+
+#include "threadedsort.h"
+
+int select_ranks(const int *data, size_t size, const size_t *ranks, size_t rank_count, int *values, size_t cutoff,
+                 size_t threads, SortStats *stats);
+
+#endif
@@ -0,0 +1,70 @@
+/*
+* @author   Jatin Jain
+* @file     stlsort.cpp
+* @desc     std::sort and std::stable_sort, serial and with std::execution::par, behind the engine signature of the benchmark:
+*           each returns a newly allocated sorted copy, or NULL on failure. Exceptions are caught here so none crosses
+*           into C. Without parallel STL support the _par variants run the serial algorithm.
+* @date     17 october 2026
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+#if defined(__has_include)
+#if __has_include(<execution>)
+#include <execution>
+#endif
+#endif
+
+#include "stlsort.h"
+#include "memtrack.h"
+
+namespace {
+
+/**
+ * @brief Copies data into a malloc'd array and sorts the copy with sort, returning NULL on failure.
+ *
+ * The copy is counted by memtrack; the buffers the library sorts allocate themselves show only in the peak RSS.
+ */
+template <typename Sort>
+int *sorted_copy(const int *data, size_t size, Sort sort) {
+    if (size == 0) return NULL;
+    int *copy = static_cast<int *>(memtrack_malloc(size * sizeof(int)));
+    if (!copy) return NULL;
+    std::memcpy(copy, data, size * sizeof(int));
+    try {
+        sort(copy, copy + size);
+    } catch (const std::exception &) {
+        memtrack_free(copy, size * sizeof(int));
+        return NULL;
+    }
+    return copy;
+}
+
+}
+
+int *stl_sort(const int *data, size_t size) {
+    return sorted_copy(data, size, [](int *first, int *last) { std::sort(first, last); });
+}
+
+int *stl_stable_sort(const int *data, size_t size) {
+    return sorted_copy(data, size, [](int *first, int *last) { std::stable_sort(first, last); });
+}
+
+int *stl_sort_par(const int *data, size_t size) {
+#if defined(__cpp_lib_execution) || defined(__cpp_lib_parallel_algorithm)
+    return sorted_copy(data, size, [](int *first, int *last) { std::sort(std::execution::par, first, last); });
+#else
+    return stl_sort(data, size);
+#endif
+}
+
+int *stl_stable_sort_par(const int *data, size_t size) {
+#if defined(__cpp_lib_execution) || defined(__cpp_lib_parallel_algorithm)
+    return sorted_copy(data, size, [](int *first, int *last) { std::stable_sort(std::execution::par, first, last); });
+#else
+    return stl_stable_sort(data, size);
+#endif
+}
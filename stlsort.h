@@ -0,0 +1,26 @@
+/*
+* @author   Jatin Jain
+* @file     stlsort.h
+* @desc     C entry points to the C++ standard library sorts, used as reference engines by the benchmark.
+* @date     17 october 2026
+*/
+
+#ifndef STLSORT_H
+#define STLSORT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int *stl_sort(const int *data, size_t size);
+int *stl_stable_sort(const int *data, size_t size);
+int *stl_sort_par(const int *data, size_t size);
+int *stl_stable_sort_par(const int *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+/*
+* @author   Jatin Jain
+* @file     strsort.c
+* @desc     multikey quicksort of strings on 8-byte chunks. Every string carries the big-endian value of its 8 bytes at the
+*           current depth, so partitioning compares cached integers instead of chasing pointers into the strings; the
+*           strings whose chunk equals the pivot's move 8 bytes deeper, unless the chunk holds their terminator, in which
+*           case they are all equal. The partitioning and the task tree are those of multikey_sort(), with one level per
+*           chunk. A descending sort complements the cached chunks and negates the byte comparisons past them, so the same
+*           partitions produce the reverse order directly.
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "strsort.h"
+#include "multikey.h"
+#include "memtrack.h"
+
+/**
+ * @brief The 8 bytes of s from depth on as a big-endian integer, zero-padded after the terminator.
+ *
+ * depth must not be past the terminator of s.
+ */
+static uint64_t load_chunk(const char *s, size_t depth) {
+    const unsigned char *p = (const unsigned char *)s + depth;
+    uint64_t chunk = 0;
+    for (int i = 0; i < 8; i++) {
+        chunk = chunk << 8 | *p;
+        if (*p) p++;
+    }
+    return chunk;
+}
+
+/**
+ * @brief Nonzero if a cached chunk holds the terminator, so strings equal up to it are equal.
+ *
+ * context points to the xor mask of the cached chunks: all ones for a descending sort.
+ */
+static int chunk_ends(uint64_t chunk, size_t level, const void *context) {
+    (void)level;
+    return ((chunk ^ *(const uint64_t *)context) & 0xff) == 0;
+}
+
+/**
+ * @brief Caches the chunk of each string at depth 8 * level, xored with the mask in context.
+ */
+static void load_chunks(MultikeyItem *items, size_t size, size_t level, const void *context) {
+    uint64_t flip = *(const uint64_t *)context;
+    for (size_t i = 0; i < size; i++) items[i].key = load_chunk((const char *)items[i].ref, level * 8) ^ flip;
+}
+
+/**
+ * @brief Compares two strings that are equal before depth 8 * level, in the order of the sort.
+ */
+static int compare_items(const MultikeyItem *a, const MultikeyItem *b, size_t level, const void *context) {
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    if (chunk_ends(a->key, level, context)) return 0;
+    size_t depth = level * 8 + 8;
+    int order = strcmp((const char *)a->ref + depth, (const char *)b->ref + depth);
+    return *(const uint64_t *)context ? -order : order;
+}
+
+/**
+ * @brief Sorts an array of strings in place in byte order (the order of strcmp()), or in reverse.
+ *
+ * @param descending Nonzero to sort in reverse byte order.
+ * @param cutoff     Part size below which no more threads are started.
+ * @param threads    Thread budget; 0 is unlimited and 1 sorts serially.
+ * @param stats      Receives the counters of the sort.
+ * @return 0 on success, or -1 if memory allocation fails; strings are then unchanged.
+ */
+int string_sort(const char **strings, size_t size, int descending, size_t cutoff, size_t threads, SortStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (size < 2) return 0;
+    MultikeyItem *items = memtrack_malloc(size * sizeof(MultikeyItem));
+    if (!items) return -1;
+    uint64_t flip = descending ? ~(uint64_t)0 : 0;
+    for (size_t i = 0; i < size; i++) items[i].ref = (uintptr_t)strings[i];
+    MultikeyOps ops = {load_chunks, compare_items, chunk_ends, &flip};
+    multikey_sort(items, size, cutoff, threads, &ops, stats);
+    stats->bytes_allocated += size * sizeof(MultikeyItem);
+    for (size_t i = 0; i < size; i++) strings[i] = (const char *)items[i].ref;
+    memtrack_free(items, size * sizeof(MultikeyItem));
+    return 0;
+}
@@ -0,0 +1,17 @@
+/*
+* @author   Jatin Jain
+* @file     strsort.h
+* @desc     parallel multikey quicksort of NUL-terminated strings, the engine behind sorter_sort_strings().
+* @date     17 october 2026
+*/
+
+#ifndef STRSORT_H
+#define STRSORT_H
+
+#include <stddef.h>
+
+#include "threadedsort.h"
+
+int string_sort(const char **strings, size_t size, int descending, size_t cutoff, size_t threads, SortStats *stats);
+
+#endif
@@ -0,0 +1,397 @@
+/*
+* @author   Jatin Jain
+* @file     textio.c
+* @desc     buffered text reader and writer for files of integers, replacing fscanf/printf on the large-file paths. The file
+*           I/O goes through the asynchronous reader and writer of aio.c.
+* @date     17 october 2026
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "textio.h"
+
+/**
+ * @brief Opens a text file of integers for reading.
+ *
+ * @param[out] r    The reader to initialise.
+ * @param[in]  path The file to read.
+ * @return 0 on success, or -1 if the file cannot be opened or memory allocation fails.
+ */
+int text_reader_open(TextReader *r, const char *path) {
+    r->len = r->pos = 0;
+    r->eof = 0;
+    r->fd = open(path, O_RDONLY);
+    if (r->fd < 0) {
+        perror("Error opening file");
+        return -1;
+    }
+    // room for the unparsed tail of the previous block in front of the next one
+    r->buf = malloc(TEXT_BUFFER_SIZE + 64);
+    if (!r->buf) {
+        perror("Memory allocation failed");
+        close(r->fd);
+        return -1;
+    }
+    if (aio_reader_open(&r->aio, NULL, r->fd, TEXT_BUFFER_SIZE) < 0) {
+        free(r->buf);
+        close(r->fd);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Closes the file and frees the buffer of a reader.
+ */
+void text_reader_close(TextReader *r) {
+    aio_reader_close(&r->aio);
+    close(r->fd);
+    free(r->buf);
+}
+
+/**
+ * @brief Moves the unread bytes to the front of the buffer and appends the next block.
+ *
+ * Only called with less than a token left unread, so the tail always fits in
+ * the room kept in front of the block.
+ *
+ * @return 0 on success, or -1 on a read error.
+ */
+static int text_reader_fill(TextReader *r) {
+    size_t rest = r->len - r->pos;
+    memmove(r->buf, r->buf + r->pos, rest);
+    r->len = rest;
+    r->pos = 0;
+
+    const char *block;
+    size_t n;
+    if (aio_reader_next(&r->aio, &block, &n) < 0) return -1;
+    memcpy(r->buf + rest, block, n);
+    r->len += n;
+    if (n < TEXT_BUFFER_SIZE) r->eof = 1;
+    return 0;
+}
+
+/**
+ * @brief Parses one integer token starting at p.
+ *
+ * @param[in]  p    Start of the token, not whitespace.
+ * @param[in]  end  End of the buffered text.
+ * @param[out] next Where parsing stopped.
+ * @param[out] out  Where the integer is stored.
+ * @return 0 on success, or -1 on a malformed or out of range token.
+ */
+static int parse_token(const char *p, const char *end, const char **next, int *out) {
+    int negative = 0;
+    if (*p == '-' || *p == '+') negative = *p++ == '-';
+
+    long long value = 0;
+    const char *digits = p;
+    while (p < end && *p >= '0' && *p <= '9' && p - digits < 11)
+        value = value * 10 + (*p++ - '0');
+    if (negative) value = -value;
+
+    if (p == digits || (p < end && *p != ' ' && (*p < '\t' || *p > '\r')) || value < INT_MIN || value > INT_MAX) {
+        fprintf(stderr, "Invalid integer in input\n");
+        return -1;
+    }
+    *next = p;
+    *out = (int)value;
+    return 0;
+}
+
+/**
+ * @brief Parses the next integer from the input.
+ *
+ * @param[in]  r   The reader.
+ * @param[out] out Where the integer is stored.
+ * @return 1 if an integer was read, 0 at end of input, or -1 on a malformed or out of range token.
+ */
+int text_reader_next(TextReader *r, int *out) {
+    for (;;) {
+        while (r->pos < r->len && (r->buf[r->pos] == ' ' || (r->buf[r->pos] >= '\t' && r->buf[r->pos] <= '\r')))
+            r->pos++;
+        if (r->pos < r->len || r->eof) break;
+        if (text_reader_fill(r) < 0) return -1;
+    }
+    if (r->pos == r->len) return 0;
+
+    // a token is at most a sign and ten digits, make sure it is buffered whole
+    if (r->len - r->pos < 16 && !r->eof && text_reader_fill(r) < 0) return -1;
+
+    const char *next;
+    if (parse_token(r->buf + r->pos, r->buf + r->len, &next, out) < 0) return -1;
+    r->pos = (size_t)(next - r->buf);
+    return 1;
+}
+
+/**
+ * @brief Parses up to capacity integers into buf.
+ *
+ * Shaped like a KMergeFill callback so a text file can be a merge source.
+ *
+ * @param[in]  reader   The TextReader.
+ * @param[out] buf      Receives the integers.
+ * @param[in]  capacity Size of buf.
+ * @param[out] len      Number of integers read, less than capacity only at end of input.
+ * @return 0 on success, or -1 on a read error or malformed token.
+ */
+int text_reader_read(void *reader, int *buf, size_t capacity, size_t *len) {
+    TextReader *r = (TextReader *)reader;
+    size_t n = 0;
+    int status = 1;
+    while (n < capacity && (status = text_reader_next(r, &buf[n])) == 1) n++;
+    *len = n;
+    return status < 0 ? -1 : 0;
+}
+
+/**
+ * @brief Reads a whole file into memory.
+ *
+ * @param[in]  path The file to read.
+ * @param[out] text Newly allocated contents, to be freed by the caller, with at least one spare byte after them.
+ * @param[out] len  Number of bytes read.
+ * @return 0 on success, or -1 on an open, read or allocation error.
+ */
+int text_load(const char *path, char **text, size_t *len) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror("Error opening file");
+        return -1;
+    }
+    size_t size = 0, capacity = TEXT_BUFFER_SIZE;
+    char *buf = malloc(capacity);
+    while (buf) {
+        size += fread(buf + size, 1, capacity - size, file);
+        if (size < capacity) break;
+        capacity *= 2;
+        char *grown = realloc(buf, capacity);
+        if (!grown) free(buf);
+        buf = grown;
+    }
+    if (!buf) {
+        perror("Memory allocation failed");
+        fclose(file);
+        return -1;
+    }
+    if (ferror(file)) {
+        perror("Error reading file");
+        free(buf);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+    *text = buf;
+    *len = size;
+    return 0;
+}
+
+/**
+ * @brief Parses every whitespace separated integer of a text held in memory.
+ *
+ * @param[in]  text   The text.
+ * @param[in]  len    Length of the text.
+ * @param[out] values Newly allocated integers, to be freed by the caller.
+ * @param[out] count  Number of integers.
+ * @param[out] checksum If not NULL, receives the checksum of the integers, computed as they are parsed.
+ * @return 0 on success, or -1 on a malformed token or allocation error.
+ */
+int text_parse(const char *text, size_t len, int **values, size_t *count, Checksum *checksum) {
+    const char *p = text, *end = text + len;
+    size_t size = 0, capacity = 1024;
+    if (checksum) checksum_init(checksum);
+    int *data = malloc(capacity * sizeof(int));
+    if (!data) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+    for (;;) {
+        while (p < end && (*p == ' ' || (*p >= '\t' && *p <= '\r'))) p++;
+        if (p == end) break;
+        if (size == capacity) {
+            capacity *= 2;
+            int *grown = realloc(data, capacity * sizeof(int));
+            if (!grown) {
+                perror("Memory allocation failed");
+                free(data);
+                return -1;
+            }
+            data = grown;
+        }
+        if (parse_token(p, end, &p, &data[size]) < 0) {
+            free(data);
+            return -1;
+        }
+        if (checksum) checksum_add(checksum, data[size]);
+        size++;
+    }
+    *values = data;
+    *count = size;
+    return 0;
+}
+
+/**
+ * @brief Splits a text held in memory into lines, in place: every newline becomes a terminator.
+ *
+ * The text becomes an arena of NUL-terminated lines that the returned
+ * pointers point into. A last line without a newline is kept; the text
+ * must have room for one more byte at text[len], as text_load() leaves.
+ *
+ * @param[out] lines Newly allocated pointers to the lines, to be freed by the caller (the lines stay in text).
+ * @param[out] count Number of lines.
+ * @return 0 on success, or -1 if memory allocation fails.
+ */
+int text_split_lines(char *text, size_t len, const char ***lines, size_t *count) {
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) n += text[i] == '\n';
+    if (len > 0 && text[len - 1] != '\n') n++;
+    const char **out = malloc((n ? n : 1) * sizeof(*out));
+    if (!out) {
+        perror("Memory allocation failed");
+        return -1;
+    }
+    text[len] = '\0';
+    size_t line = 0;
+    char *start = text;
+    for (char *p = text; p < text + len; p++) {
+        if (*p != '\n') continue;
+        *p = '\0';
+        out[line++] = start;
+        start = p + 1;
+    }
+    if (start < text + len) out[line++] = start;
+    *lines = out;
+    *count = line;
+    return 0;
+}
+
+/**
+ * @brief Opens a text file for writing integers.
+ *
+ * @param[out] w    The writer to initialise.
+ * @param[in]  path The file to write, or NULL for stdout.
+ * @return 0 on success, or -1 if the file cannot be opened or memory allocation fails.
+ */
+int text_writer_open(TextWriter *w, const char *path) {
+    w->len = 0;
+    fflush(stdout);
+    w->fd = path ? open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666) : STDOUT_FILENO;
+    if (w->fd < 0) {
+        perror("Error opening output");
+        return -1;
+    }
+    w->buf = malloc(TEXT_BUFFER_SIZE);
+    if (!w->buf || aio_writer_open(&w->aio, w->fd, TEXT_BUFFER_SIZE) < 0) {
+        if (!w->buf) perror("Memory allocation failed");
+        free(w->buf);
+        if (w->fd != STDOUT_FILENO) close(w->fd);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes the buffered text to the output file.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+int text_writer_flush(TextWriter *w) {
+    if (aio_writer_write(&w->aio, w->buf, w->len) < 0) return -1;
+    w->len = 0;
+    return 0;
+}
+
+/**
+ * @brief Appends an integer and a newline to the output.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+int text_writer_put(TextWriter *w, int value) {
+    if (TEXT_BUFFER_SIZE - w->len < 16 && text_writer_flush(w) < 0) return -1;
+
+    char digits[12];
+    size_t n = 0;
+    unsigned int u = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    if (value < 0) w->buf[w->len++] = '-';
+    while (n) w->buf[w->len++] = digits[--n];
+    w->buf[w->len++] = '\n';
+    return 0;
+}
+
+/**
+ * @brief Appends a position or count and a newline to the output.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+int text_writer_put_index(TextWriter *w, size_t value) {
+    if (TEXT_BUFFER_SIZE - w->len < 24 && text_writer_flush(w) < 0) return -1;
+
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n) w->buf[w->len++] = digits[--n];
+    w->buf[w->len++] = '\n';
+    return 0;
+}
+
+/**
+ * @brief Appends a line of len bytes and a newline to the output; lines longer than the buffer are written in pieces.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+int text_writer_put_line(TextWriter *w, const char *line, size_t len) {
+    while (len > 0) {
+        if (w->len == TEXT_BUFFER_SIZE && text_writer_flush(w) < 0) return -1;
+        size_t piece = TEXT_BUFFER_SIZE - w->len;
+        if (piece > len) piece = len;
+        memcpy(w->buf + w->len, line, piece);
+        w->len += piece;
+        line += piece;
+        len -= piece;
+    }
+    if (w->len == TEXT_BUFFER_SIZE && text_writer_flush(w) < 0) return -1;
+    w->buf[w->len++] = '\n';
+    return 0;
+}
+
+/**
+ * @brief Appends len integers to the output, shaped like a KMergeFlush callback.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+int text_writer_write(void *writer, const int *buf, size_t len) {
+    TextWriter *w = (TextWriter *)writer;
+    for (size_t i = 0; i < len; i++)
+        if (text_writer_put(w, buf[i]) < 0) return -1;
+    return 0;
+}
+
+/**
+ * @brief Flushes and closes a writer. stdout is flushed but left open.
+ *
+ * @return 0 on success, or -1 on a write error.
+ */
+int text_writer_close(TextWriter *w) {
+    int status = text_writer_flush(w);
+    if (aio_writer_close(&w->aio) < 0) status = -1;
+    free(w->buf);
+    if (w->fd != STDOUT_FILENO && close(w->fd) != 0 && status == 0) {
+        perror("Error writing output");
+        status = -1;
+    }
+    return status;
+}
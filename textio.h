@@ -0,0 +1,61 @@
+/*
+* @author   Jatin Jain
+* @file     textio.h
+* @desc     buffered reading and writing of integers in the text format used by the input files: whitespace separated on input, one per line on output.
+*           Lines of text are split in place for the string sort and written back one per line.
+* @date     17 october 2026
+*/
+
+#ifndef TEXTIO_H
+#define TEXTIO_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "aio.h"
+#include "verify.h"
+
+#define TEXT_BUFFER_SIZE (1 << 20)      // bytes buffered by the text reader and writer
+
+/**
+ * @brief Buffered reader of whitespace separated integers from a text file.
+ * The next block of the file is read ahead while the current one is parsed.
+ */
+typedef struct {
+    int fd;
+    AioReader aio;
+    char *buf;
+    size_t len;
+    size_t pos;
+    int eof;
+} TextReader;
+
+/**
+ * @brief Buffered writer of integers to a text file, one per line.
+ * Full buffers are written in the background while the next one is formatted.
+ */
+typedef struct {
+    int fd;
+    AioWriter aio;
+    char *buf;
+    size_t len;
+} TextWriter;
+
+int text_reader_open(TextReader *r, const char *path);
+int text_reader_next(TextReader *r, int *out);
+int text_reader_read(void *reader, int *buf, size_t capacity, size_t *len);
+void text_reader_close(TextReader *r);
+
+int text_load(const char *path, char **text, size_t *len);
+int text_parse(const char *text, size_t len, int **values, size_t *count, Checksum *checksum);
+int text_split_lines(char *text, size_t len, const char ***lines, size_t *count);
+
+int text_writer_open(TextWriter *w, const char *path);
+int text_writer_put(TextWriter *w, int value);
+int text_writer_put_index(TextWriter *w, size_t value);
+int text_writer_put_line(TextWriter *w, const char *line, size_t len);
+int text_writer_flush(TextWriter *w);
+int text_writer_write(void *writer, const int *buf, size_t len);
+int text_writer_close(TextWriter *w);
+
+#endif
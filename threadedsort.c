@@ -0,0 +1,668 @@
+/*
+* @author   Jatin Jain
+* @file     threadedsort.c
+* @desc     the sorter object of libthreadedsort. The engines of quicksort.c return a newly allocated sorted copy; a sorter
+*           copies it into the caller's buffer (or back over the input) and frees it, so callers never handle the
+*           engines' allocations. The threaded engine runs its root task in the calling thread. The typed sorts map each
+*           value to an unsigned key of the same width whose unsigned order is the order of the values (keys.h), radix sort
+*           the keys and map them back; a macro instantiates them per type. A descending sort complements the keys, which
+*           reverses their unsigned order, so the radix passes are the same in both directions.
+* @date     17 october 2026
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "threadedsort.h"
+#include "quicksort.h"
+#include "memtrack.h"
+#include "radix.h"
+#include "strsort.h"
+#include "cmpsort.h"
+#include "colsort.h"
+#include "segsort.h"
+#include "topk.h"
+#include "selection.h"
+#include "keys.h"
+
+struct Sorter {
+    SortEngine engine;
+    size_t threads;
+    size_t cutoff;
+    SortOrder order;
+    SortStats stats;
+};
+
+/**
+ * @brief Creates a sorter with the threaded engine, unlimited threads, a cutoff of 0 (a thread on every level) and
+ *        ascending order.
+ *
+ * @return The sorter, or NULL if it cannot be allocated.
+ */
+Sorter *sorter_create(void) {
+    Sorter *sorter = calloc(1, sizeof(*sorter));
+    if (!sorter) return NULL;
+    sorter->engine = SORT_ENGINE_THREADED;
+    return sorter;
+}
+
+void sorter_destroy(Sorter *sorter) {
+    free(sorter);
+}
+
+/**
+ * @brief Selects the engine of the next sorts.
+ *
+ * @return 0 on success, or -1 if engine is not a SortEngine.
+ */
+int sorter_set_engine(Sorter *sorter, SortEngine engine) {
+    if (engine != SORT_ENGINE_SERIAL && engine != SORT_ENGINE_THREADED) return -1;
+    sorter->engine = engine;
+    return 0;
+}
+
+/**
+ * @brief Sets how many threads the threaded engine may sort with at once; 0 leaves them unlimited, 1 sorts serially.
+ */
+void sorter_set_threads(Sorter *sorter, size_t threads) {
+    sorter->threads = threads;
+}
+
+/**
+ * @brief Sets the subarray size below which the threaded engine sorts in the current thread instead of spawning one.
+ */
+void sorter_set_cutoff(Sorter *sorter, size_t cutoff) {
+    sorter->cutoff = cutoff;
+}
+
+/**
+ * @brief Selects the direction of the next sorts.
+ *
+ * @return 0 on success, or -1 if order is not a SortOrder.
+ */
+int sorter_set_order(Sorter *sorter, SortOrder order) {
+    if (order != SORT_ASCENDING && order != SORT_DESCENDING) return -1;
+    sorter->order = order;
+    return 0;
+}
+
+/**
+ * @brief Sorts data in place.
+ *
+ * @return 0 on success, or -1 if the engine runs out of memory; data is then left unchanged.
+ */
+int sorter_sort(Sorter *sorter, int *data, size_t size) {
+    return sorter_sort_into(sorter, data, size, data);
+}
+
+/**
+ * @brief Writes the size elements of data to out in the sorter's order. out may be data itself.
+ *
+ * @return 0 on success, or -1 if the engine runs out of memory.
+ */
+int sorter_sort_into(Sorter *sorter, const int *data, size_t size, int *out) {
+    int *sorted;
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    if (size == 0) return 0;
+    if (sorter->engine == SORT_ENGINE_SERIAL) {
+        sorter->stats.tasks = 1;
+        sorted = quicksort_counted(size, data, sorter->order == SORT_DESCENDING, &sorter->stats);
+    } else {
+        ThreadArgs args = {(int *)data, size, sorter->cutoff, sorter->threads, 0, sorter->order == SORT_DESCENDING, {0}};
+        sorted = quicksort_threaded(&args);
+        sorter->stats = args.stats;
+    }
+    if (!sorted) return -1;
+    memcpy(out, sorted, size * sizeof(int));
+    memtrack_free(sorted, size * sizeof(int));
+    return 0;
+}
+
+/**
+ * @brief Sorts every segment of values in place and independently: segment s is values[offsets[s]] up to, not
+ *        including, values[offsets[s + 1]].
+ *
+ * Meant for many small arrays stored back to back: the segments are split
+ * between the workers by element count and each is sorted by a kernel
+ * picked for its size (a sorting network, insertion sort or an in-place
+ * quicksort), with no allocation per segment. Uses the sorter's thread
+ * budget and order; a single large segment is sorted by one worker.
+ *
+ * @param offsets segment_count + 1 nondecreasing positions in values.
+ * @return 0 on success, or -1 if the offsets decrease or the workers cannot be set up; values are then unchanged.
+ */
+int sorter_sort_segments(Sorter *sorter, int *values, const size_t *offsets, size_t segment_count) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    for (size_t s = 0; s < segment_count; s++)
+        if (offsets[s] > offsets[s + 1]) return -1;
+    size_t threads = sorter->engine == SORT_ENGINE_SERIAL ? 1 : sorter->threads;
+    return segment_sort(values, offsets, segment_count, sorter->order == SORT_DESCENDING, threads, &sorter->stats);
+}
+
+/**
+ * @brief Writes the k values of data that sort first (the smallest, or the largest in descending order) to out, in
+ *        the sorter's order, without sorting the rest.
+ *
+ * A quickselect on the three-way partition narrows data down to its first
+ * k values, which are then sorted like sorter_sort_into() with the
+ * sorter's engine. The counters cover both steps. For a stream, or a k
+ * much smaller than size, the TopK heap avoids the partition buffers.
+ *
+ * @param k At most size.
+ * @return 0 on success, or -1 if k is larger than size or memory runs out.
+ */
+int sorter_top_k(Sorter *sorter, const int *data, size_t size, size_t k, int *out) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    if (k > size) return -1;
+    SortStats selection;
+    if (select_top_k(data, size, k, sorter->order == SORT_DESCENDING, out, &selection) < 0) return -1;
+    if (sorter_sort(sorter, out, k) < 0) return -1;
+    sort_stats_add(&sorter->stats, &selection);
+    return 0;
+}
+
+#define NEVER_NAN(v) ((void)(v), 0)
+
+// xor mask applied to every key: all ones complements the keys into descending order
+#define KEY_FLIP(KEY, sorter) ((sorter)->order == SORT_DESCENDING ? (KEY)~(KEY)0 : (KEY)0)
+
+/*
+ * Defines sorter_sort_NAME() for values of type T with keys of type KEY.
+ * Values that are not NaN (IS_NAN) are encoded into a key buffer and
+ * sorted; data is only written once the sort has succeeded, first packing
+ * the NaNs behind the decoded keys in input order. The keys are flipped
+ * for a descending sort while they are encoded and decoded, so NaNs stay
+ * last in both directions.
+ */
+#define DEFINE_TYPED_SORT(NAME, T, KEY, RADIX, IS_NAN)                                                                  \
+int sorter_sort_##NAME(Sorter *sorter, T *data, size_t size) {                                                          \
+    memset(&sorter->stats, 0, sizeof(sorter->stats));                                                                   \
+    if (size == 0) return 0;                                                                                            \
+    KEY *keys = memtrack_malloc(size * sizeof(KEY));                                                                    \
+    if (!keys) return -1;                                                                                               \
+    const KEY flip = KEY_FLIP(KEY, sorter);                                                                             \
+    size_t count = 0;                                                                                                   \
+    for (size_t i = 0; i < size; i++)                                                                                   \
+        if (!IS_NAN(data[i])) keys[count++] = encode_##NAME(data[i]) ^ flip;                                            \
+    size_t threads = sorter->engine == SORT_ENGINE_SERIAL ? 1 : sorter->threads;                                        \
+    if (RADIX(keys, count, threads, &sorter->stats) < 0) {                                                              \
+        memtrack_free(keys, size * sizeof(KEY));                                                                        \
+        return -1;                                                                                                      \
+    }                                                                                                                   \
+    if (count < size) {                                                                                                 \
+        size_t nans = 0;                                                                                                \
+        for (size_t i = 0; i < size; i++)                                                                               \
+            if (IS_NAN(data[i])) data[nans++] = data[i];                                                                \
+        memmove(data + count, data, nans * sizeof(T));                                                                  \
+    }                                                                                                                   \
+    for (size_t i = 0; i < count; i++) data[i] = decode_##NAME(keys[i] ^ flip);                                         \
+    sorter->stats.bytes_allocated += size * sizeof(KEY);                                                                \
+    memtrack_free(keys, size * sizeof(KEY));                                                                            \
+    return 0;                                                                                                           \
+}
+
+DEFINE_TYPED_SORT(int32, int32_t, uint32_t, radix_sort_u32, NEVER_NAN)
+DEFINE_TYPED_SORT(uint32, uint32_t, uint32_t, radix_sort_u32, NEVER_NAN)
+DEFINE_TYPED_SORT(int64, int64_t, uint64_t, radix_sort_u64, NEVER_NAN)
+DEFINE_TYPED_SORT(uint64, uint64_t, uint64_t, radix_sort_u64, NEVER_NAN)
+DEFINE_TYPED_SORT(float, float, uint32_t, radix_sort_u32, isnan)
+DEFINE_TYPED_SORT(double, double, uint64_t, radix_sort_u64, isnan)
+
+/*
+ * Defines sort_records_NAME_P(), which sorts count records of a key of type
+ * T (encoded as KEY) followed by a P-byte payload by their key, like DEFINE_TYPED_SORT: the
+ * records without a NaN key go through the radix sort as RECORD items, and
+ * the NaN records are packed behind them in input order.
+ */
+#define DEFINE_RECORD_SORT(NAME, T, KEY, P, RECORD, RADIX, IS_NAN)                                                      \
+static int sort_records_##NAME##_##P(Sorter *sorter, unsigned char *records, size_t size) {                             \
+    const size_t record_size = sizeof(T) + P;                                                                           \
+    RECORD *items = memtrack_malloc(size * sizeof(RECORD));                                                             \
+    if (!items) return -1;                                                                                              \
+    const KEY flip = KEY_FLIP(KEY, sorter);                                                                             \
+    size_t count = 0;                                                                                                   \
+    for (size_t i = 0; i < size; i++) {                                                                                 \
+        T key;                                                                                                          \
+        memcpy(&key, records + i * record_size, sizeof(T));                                                             \
+        if (IS_NAN(key)) continue;                                                                                      \
+        items[count].key = encode_##NAME(key) ^ flip;                                                                   \
+        memcpy(items[count++].payload, records + i * record_size + sizeof(T), P);                                       \
+    }                                                                                                                   \
+    size_t threads = sorter->engine == SORT_ENGINE_SERIAL ? 1 : sorter->threads;                                        \
+    if (RADIX(items, count, threads, &sorter->stats) < 0) {                                                             \
+        memtrack_free(items, size * sizeof(RECORD));                                                                    \
+        return -1;                                                                                                      \
+    }                                                                                                                   \
+    if (count < size) {                                                                                                 \
+        size_t nans = 0;                                                                                                \
+        for (size_t i = 0; i < size; i++) {                                                                             \
+            T key;                                                                                                      \
+            memcpy(&key, records + i * record_size, sizeof(T));                                                         \
+            if (IS_NAN(key)) memmove(records + nans++ * record_size, records + i * record_size, record_size);           \
+        }                                                                                                               \
+        memmove(records + count * record_size, records, nans * record_size);                                            \
+    }                                                                                                                   \
+    for (size_t i = 0; i < count; i++) {                                                                                \
+        T key = decode_##NAME(items[i].key ^ flip);                                                                     \
+        memcpy(records + i * record_size, &key, sizeof(T));                                                             \
+        memcpy(records + i * record_size + sizeof(T), items[i].payload, P);                                             \
+    }                                                                                                                   \
+    sorter->stats.bytes_allocated += size * sizeof(RECORD);                                                             \
+    memtrack_free(items, size * sizeof(RECORD));                                                                        \
+    return 0;                                                                                                           \
+}
+
+#define DEFINE_RECORD_SORTS(NAME, T, BITS, IS_NAN)                                                                      \
+DEFINE_RECORD_SORT(NAME, T, uint##BITS##_t, 4, RadixRecord##BITS##x4, radix_sort_r##BITS##x4, IS_NAN)                   \
+DEFINE_RECORD_SORT(NAME, T, uint##BITS##_t, 8, RadixRecord##BITS##x8, radix_sort_r##BITS##x8, IS_NAN)                   \
+DEFINE_RECORD_SORT(NAME, T, uint##BITS##_t, 16, RadixRecord##BITS##x16, radix_sort_r##BITS##x16, IS_NAN)
+
+DEFINE_RECORD_SORTS(int32, int32_t, 32, NEVER_NAN)
+DEFINE_RECORD_SORTS(uint32, uint32_t, 32, NEVER_NAN)
+DEFINE_RECORD_SORTS(int64, int64_t, 64, NEVER_NAN)
+DEFINE_RECORD_SORTS(uint64, uint64_t, 64, NEVER_NAN)
+DEFINE_RECORD_SORTS(float, float, 32, isnan)
+DEFINE_RECORD_SORTS(double, double, 64, isnan)
+
+typedef int (*RecordSort)(Sorter *sorter, unsigned char *records, size_t size);
+
+#define RECORD_SORTS(NAME) {sort_records_##NAME##_4, sort_records_##NAME##_8, sort_records_##NAME##_16}
+
+// indexed by key type, then by payload size 4, 8, 16
+static const RecordSort record_sorts[][3] = {
+    [SORT_KEY_INT32] = RECORD_SORTS(int32),
+    [SORT_KEY_UINT32] = RECORD_SORTS(uint32),
+    [SORT_KEY_INT64] = RECORD_SORTS(int64),
+    [SORT_KEY_UINT64] = RECORD_SORTS(uint64),
+    [SORT_KEY_FLOAT] = RECORD_SORTS(float),
+    [SORT_KEY_DOUBLE] = RECORD_SORTS(double),
+};
+
+static const size_t key_sizes[] = {
+    [SORT_KEY_INT32] = 4, [SORT_KEY_UINT32] = 4, [SORT_KEY_INT64] = 8,
+    [SORT_KEY_UINT64] = 8, [SORT_KEY_FLOAT] = 4, [SORT_KEY_DOUBLE] = 8,
+};
+
+/**
+ * @brief Sorts records in place by a key at their start, moving the rest of each record with its key.
+ *
+ * The records are packed, record_size bytes apart; the payload after the
+ * key must be 4, 8 or 16 bytes (a struct of a key and its payload works
+ * as is, padding included). Records with equal keys keep their order.
+ *
+ * @return 0 on success, or -1 on an unsupported key type or record size, or when out of memory; records are then
+ *         unchanged.
+ */
+int sorter_sort_records(Sorter *sorter, SortKeyType key_type, void *records, size_t size, size_t record_size) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    if ((unsigned)key_type > SORT_KEY_DOUBLE || record_size <= key_sizes[key_type]) return -1;
+    size_t payload = record_size - key_sizes[key_type];
+    int column = payload == 4 ? 0 : payload == 8 ? 1 : payload == 16 ? 2 : -1;
+    if (column < 0) return -1;
+    if (size == 0) return 0;
+    return record_sorts[key_type][column](sorter, records, size);
+}
+
+/**
+ * @brief Pairs each key with its position and sorts the pairs as records.
+ *
+ * Positions take 4 bytes below 2^32 keys and 8 above.
+ *
+ * @param[out] record_size Bytes per pair; the position follows the key.
+ * @return The sorted pairs, allocated with memtrack_malloc(), or NULL on failure.
+ */
+static unsigned char *sorted_positions(Sorter *sorter, SortKeyType key_type, const void *keys, size_t size,
+                                       size_t *record_size) {
+    size_t key_size = key_sizes[key_type];
+    size_t index_size = size <= UINT32_MAX ? 4 : 8;
+    *record_size = key_size + index_size;
+    unsigned char *records = memtrack_malloc(size * *record_size);
+    if (!records) return NULL;
+    for (size_t i = 0; i < size; i++) {
+        unsigned char *record = records + i * *record_size;
+        memcpy(record, (const unsigned char *)keys + i * key_size, key_size);
+        if (index_size == 4) {
+            uint32_t index = (uint32_t)i;
+            memcpy(record + key_size, &index, 4);
+        } else {
+            uint64_t index = i;
+            memcpy(record + key_size, &index, 8);
+        }
+    }
+    if (sorter_sort_records(sorter, key_type, records, size, *record_size) < 0) {
+        memtrack_free(records, size * *record_size);
+        return NULL;
+    }
+    return records;
+}
+
+/**
+ * @brief The position stored after the key of a pair from sorted_positions().
+ */
+static size_t position_of(const unsigned char *record, size_t key_size, size_t record_size) {
+    if (record_size - key_size == 4) {
+        uint32_t index;
+        memcpy(&index, record + key_size, 4);
+        return index;
+    }
+    uint64_t index;
+    memcpy(&index, record + key_size, 8);
+    return (size_t)index;
+}
+
+/**
+ * @brief Sorts an array of keys and permutes the payload columns that go with it the same way.
+ *
+ * The keys are paired with their positions and sorted as records; each
+ * column is then permuted in one gather pass through a scratch buffer.
+ * Equal keys keep their order.
+ *
+ * @param[in,out] keys         The keys, of key_type.
+ * @param[in,out] columns      column_count arrays of size elements each, moved with the keys.
+ * @param[in]     column_sizes Element size in bytes of each column.
+ * @return 0 on success, or -1 on an unsupported key type or when out of memory; nothing is changed then.
+ */
+int sorter_sort_soa(Sorter *sorter, SortKeyType key_type, void *keys, size_t size, void *const *columns,
+                    const size_t *column_sizes, size_t column_count) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    if ((unsigned)key_type > SORT_KEY_DOUBLE) return -1;
+    if (size == 0) return 0;
+
+    size_t key_size = key_sizes[key_type], widest = 0, record_size;
+    for (size_t c = 0; c < column_count; c++)
+        if (column_sizes[c] > widest) widest = column_sizes[c];
+    unsigned char *scratch = widest ? memtrack_malloc(size * widest) : NULL;
+    if (widest && !scratch) return -1;
+    unsigned char *records = sorted_positions(sorter, key_type, keys, size, &record_size);
+    if (!records) {
+        memtrack_free(scratch, size * widest);
+        return -1;
+    }
+
+    for (size_t i = 0; i < size; i++) memcpy((unsigned char *)keys + i * key_size, records + i * record_size, key_size);
+    for (size_t c = 0; c < column_count; c++) {
+        size_t width = column_sizes[c];
+        unsigned char *column = columns[c];
+        for (size_t i = 0; i < size; i++) {
+            size_t from = position_of(records + i * record_size, key_size, record_size);
+            memcpy(scratch + i * width, column + from * width, width);
+        }
+        memcpy(column, scratch, size * width);
+    }
+    sorter->stats.bytes_allocated += size * (record_size + widest);
+    memtrack_free(records, size * record_size);
+    memtrack_free(scratch, size * widest);
+    return 0;
+}
+
+/**
+ * @brief The big-endian 64-bit word at p.
+ */
+static uint64_t load_word(const unsigned char *p) {
+    uint64_t word = 0;
+    for (int i = 0; i < 8; i++) word = word << 8 | p[i];
+    return word;
+}
+
+/**
+ * @brief Sorts records in place by a composite key of fields anywhere in the record, each ascending or descending.
+ *
+ * Every record's key is normalised (sort_key_encode()) and cut into
+ * big-endian 64-bit words, so a key of any number of fields sorts on the
+ * unsigned radix engine: (word, position) pairs are radix sorted once per
+ * word, last word first, and because each pass is stable the result is
+ * ordered by the whole key. The records are then permuted in one gather
+ * pass. The fields' own orders give the direction; the sorter's order is
+ * not used. Records with equal keys keep their order and NaNs go last.
+ *
+ * @param fields Fields of the key, most significant first; each must lie within record_size.
+ * @return 0 on success, or -1 on an unsupported field or when out of memory; records are then unchanged.
+ */
+int sorter_sort_by_fields(Sorter *sorter, void *records, size_t size, size_t record_size,
+                          const SortKeyField *fields, size_t field_count) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    size_t width = sort_key_width(fields, field_count);
+    if (field_count > 0 && width == 0) return -1;
+    for (size_t f = 0; f < field_count; f++) {
+        if (fields[f].order != SORT_ASCENDING && fields[f].order != SORT_DESCENDING) return -1;
+        if (fields[f].offset > record_size || record_size - fields[f].offset < key_sizes[fields[f].type]) return -1;
+    }
+    if (size < 2 || width == 0) return 0;
+
+    size_t words = (width + 7) / 8;
+    uint64_t *keys = memtrack_malloc(size * words * sizeof(uint64_t));
+    RadixRecord64x8 *items = memtrack_malloc(size * sizeof(RadixRecord64x8));
+    unsigned char *scratch = memtrack_malloc(size * record_size);
+    unsigned char *bytes = memtrack_malloc(words * 8);
+    int status = -1;
+    if (!keys || !items || !scratch || !bytes) goto done;
+
+    memset(bytes, 0, words * 8);        // the padding after the last field stays zero
+    unsigned char *base = records;
+    for (size_t i = 0; i < size; i++) {
+        sort_key_encode(fields, field_count, base + i * record_size, bytes);
+        for (size_t w = 0; w < words; w++) keys[i * words + w] = load_word(bytes + w * 8);
+        uint64_t position = i;
+        memcpy(items[i].payload, &position, 8);
+    }
+    size_t threads = sorter->engine == SORT_ENGINE_SERIAL ? 1 : sorter->threads;
+    for (size_t w = words; w-- > 0;) {
+        for (size_t i = 0; i < size; i++) {
+            uint64_t position;
+            memcpy(&position, items[i].payload, 8);
+            items[i].key = keys[position * words + w];
+        }
+        SortStats pass;
+        memset(&pass, 0, sizeof(pass));
+        if (radix_sort_r64x8(items, size, threads, &pass) < 0) goto done;
+        sort_stats_add(&sorter->stats, &pass);
+    }
+    for (size_t i = 0; i < size; i++) {
+        uint64_t position;
+        memcpy(&position, items[i].payload, 8);
+        memcpy(scratch + i * record_size, base + position * record_size, record_size);
+    }
+    memcpy(base, scratch, size * record_size);
+    sorter->stats.bytes_allocated += size * (words * sizeof(uint64_t) + sizeof(RadixRecord64x8) + record_size);
+    status = 0;
+
+done:
+    memtrack_free(keys, size * words * sizeof(uint64_t));
+    memtrack_free(items, size * sizeof(RadixRecord64x8));
+    memtrack_free(scratch, size * record_size);
+    memtrack_free(bytes, words * 8);
+    return status;
+}
+
+/**
+ * @brief Writes the positions of the keys in sorted order to indices, leaving the keys as they are.
+ *
+ * The keys are sorted as (key, position) pairs rather than by comparing
+ * keys through the positions, so the sort streams through memory and runs
+ * on the parallel radix engine. Equal keys are listed in position order.
+ *
+ * @param[in]  keys    The keys, of key_type.
+ * @param[out] indices size positions: keys[indices[0]] is the smallest key.
+ * @return 0 on success, or -1 on an unsupported key type or when out of memory.
+ */
+int sorter_argsort(Sorter *sorter, SortKeyType key_type, const void *keys, size_t size, size_t *indices) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    if ((unsigned)key_type > SORT_KEY_DOUBLE) return -1;
+    if (size == 0) return 0;
+    size_t key_size = key_sizes[key_type], record_size;
+    unsigned char *records = sorted_positions(sorter, key_type, keys, size, &record_size);
+    if (!records) return -1;
+    for (size_t i = 0; i < size; i++) indices[i] = position_of(records + i * record_size, key_size, record_size);
+    sorter->stats.bytes_allocated += size * record_size;
+    memtrack_free(records, size * record_size);
+    return 0;
+}
+
+/**
+ * @brief Writes the order that sorts the rows of a columnar table by several columns, first column first.
+ *
+ * Row i of the table is (columns[0][i], columns[1][i], ...). Rows are
+ * ordered by the first column, rows with equal first values by the second,
+ * and so on; rows equal in every column are listed in position order. Each
+ * column is read only for the rows that tie on all the columns before it,
+ * and the columns are left as they are. Uses the sorter's engine, thread
+ * budget and cutoff like the int sort.
+ *
+ * @param key_types    Type of each column.
+ * @param columns      column_count arrays of size values each.
+ * @param orders       Direction of each column, or NULL to sort every column in the sorter's order.
+ * @param[out] indices size row positions: row indices[0] sorts first.
+ * @return 0 on success, or -1 on an unsupported key type or order, or when out of memory.
+ */
+int sorter_argsort_columns(Sorter *sorter, const SortKeyType *key_types, const void *const *columns,
+                           const SortOrder *orders, size_t column_count, size_t size, size_t *indices) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    for (size_t c = 0; c < column_count; c++) {
+        if ((unsigned)key_types[c] > SORT_KEY_DOUBLE) return -1;
+        if (orders && orders[c] != SORT_ASCENDING && orders[c] != SORT_DESCENDING) return -1;
+    }
+    SortOrder *same = NULL;
+    if (!orders && column_count > 0) {
+        same = malloc(column_count * sizeof(SortOrder));
+        if (!same) return -1;
+        for (size_t c = 0; c < column_count; c++) same[c] = sorter->order;
+        orders = same;
+    }
+    size_t threads = sorter->engine == SORT_ENGINE_SERIAL ? 1 : sorter->threads;
+    int status = column_sort(key_types, columns, orders, column_count, size, sorter->cutoff, threads, indices,
+                             &sorter->stats);
+    free(same);
+    return status;
+}
+
+/**
+ * @brief Finds the elements at rank_count positions of the ascending sorted order of data; out[i] is at ranks[i].
+ *
+ * The ranks may come in any order and repeat. They are put in ascending
+ * order with an argsort so the selection can split them between the parts
+ * of each partition, and the answers are scattered back to the callers'
+ * order.
+ */
+static int select_ascending(Sorter *sorter, const int *data, size_t size, const size_t *ranks, size_t rank_count,
+                            int descending, int *out) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    for (size_t r = 0; r < rank_count; r++)
+        if (ranks[r] >= size) return -1;
+    if (rank_count == 0) return 0;
+
+    uint64_t *keys = malloc(rank_count * sizeof(uint64_t));
+    size_t *order = malloc(rank_count * sizeof(size_t));
+    size_t *sorted = malloc(rank_count * sizeof(size_t));
+    int *values = malloc(rank_count * sizeof(int));
+    int status = -1;
+    if (!keys || !order || !sorted || !values) goto done;
+    for (size_t r = 0; r < rank_count; r++) keys[r] = descending ? size - 1 - ranks[r] : ranks[r];
+    SortOrder caller_order = sorter->order;
+    sorter->order = SORT_ASCENDING;
+    status = sorter_argsort(sorter, SORT_KEY_UINT64, keys, rank_count, order);
+    sorter->order = caller_order;
+    if (status < 0) goto done;
+    for (size_t r = 0; r < rank_count; r++) sorted[r] = (size_t)keys[order[r]];
+
+    size_t threads = sorter->engine == SORT_ENGINE_SERIAL ? 1 : sorter->threads;
+    status = select_ranks(data, size, sorted, rank_count, values, sorter->cutoff, threads, &sorter->stats);
+    if (status == 0)
+        for (size_t r = 0; r < rank_count; r++) out[order[r]] = values[r];
+
+done:
+    free(keys);
+    free(order);
+    free(sorted);
+    free(values);
+    return status;
+}
+
+/**
+ * @brief Writes the element at each rank of the sorted order of data to out (the nth element), without sorting data.
+ *
+ * Rank 0 is the element that sorts first in the sorter's order. All the
+ * ranks are answered in one pass of three-way partitions that descends
+ * only into the parts holding ranks, in parallel where two parts do; a
+ * part holding a single rank takes a sampled pivot next to it (Floyd and
+ * Rivest), so it shrinks faster than with a median pivot. Uses the
+ * sorter's engine, thread budget and cutoff.
+ *
+ * @param ranks rank_count positions below size, in any order.
+ * @return 0 on success, or -1 if a rank is out of range or memory runs out.
+ */
+int sorter_select(Sorter *sorter, const int *data, size_t size, const size_t *ranks, size_t rank_count, int *out) {
+    return select_ascending(sorter, data, size, ranks, rank_count, sorter->order == SORT_DESCENDING, out);
+}
+
+/**
+ * @brief Writes the quantiles of data to out: out[i] is the smallest element with at least a fraction quantiles[i]
+ *        of data at or below it (the nearest-rank definition, so 0.99 of 1000 elements is the 990th smallest).
+ *
+ * Quantiles always count from the smallest element, whatever the sorter's
+ * order. They are answered together by sorter_select(), so p50, p99 and
+ * p999 cost about as much as one selection and far less than a sort.
+ *
+ * @param quantiles count fractions between 0 and 1.
+ * @return 0 on success, or -1 if data is empty, a quantile is outside [0, 1] or memory runs out.
+ */
+int sorter_quantiles(Sorter *sorter, const int *data, size_t size, const double *quantiles, size_t count, int *out) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    if (count == 0) return 0;
+    if (size == 0) return -1;
+    size_t *ranks = malloc(count * sizeof(size_t));
+    if (!ranks) return -1;
+    for (size_t q = 0; q < count; q++) {
+        if (!(quantiles[q] >= 0.0 && quantiles[q] <= 1.0)) {
+            free(ranks);
+            return -1;
+        }
+        double position = ceil(quantiles[q] * (double)size);
+        ranks[q] = position < 1.0 ? 0 : (size_t)position - 1;
+        if (ranks[q] >= size) ranks[q] = size - 1;
+    }
+    int status = select_ascending(sorter, data, size, ranks, count, 0, out);
+    free(ranks);
+    return status;
+}
+
+/**
+ * @brief Sorts an array of NUL-terminated strings in place, in byte order (the order of strcmp()).
+ *
+ * Only the pointers move; the strings can live anywhere, e.g. in one arena.
+ * Uses the sorter's engine, thread budget, cutoff and order like the int
+ * sort.
+ *
+ * @return 0 on success, or -1 if memory allocation fails; strings is then unchanged.
+ */
+int sorter_sort_strings(Sorter *sorter, const char **strings, size_t size) {
+    size_t threads = sorter->engine == SORT_ENGINE_SERIAL ? 1 : sorter->threads;
+    return string_sort(strings, size, sorter->order == SORT_DESCENDING, sorter->cutoff, threads, &sorter->stats);
+}
+
+/**
+ * @brief Sorts size elements of elem_size bytes in place by a comparator, for element types the typed sorts do not
+ *        cover.
+ *
+ * Elements that compare equal keep their order, in both directions. Uses
+ * the sorter's engine, thread budget and cutoff like the int sort; the
+ * sort allocates size * (elem_size + 1) bytes of scratch space up front.
+ *
+ * @param compare Orders two elements; see SortCompare. context is passed through to it.
+ * @return 0 on success, or -1 if elem_size is 0 or memory allocation fails; base is then unchanged.
+ */
+int sorter_sort_compare(Sorter *sorter, void *base, size_t size, size_t elem_size, SortCompare compare,
+                        void *context) {
+    memset(&sorter->stats, 0, sizeof(sorter->stats));
+    if (elem_size == 0) return -1;
+    size_t threads = sorter->engine == SORT_ENGINE_SERIAL ? 1 : sorter->threads;
+    return compare_sort(base, size, elem_size, compare, context, sorter->order == SORT_DESCENDING, sorter->cutoff,
+                        threads, &sorter->stats);
+}
+
+/**
+ * @brief The counters of the last sort.
+ */
+const SortStats *sorter_stats(const Sorter *sorter) {
+    return &sorter->stats;
+}
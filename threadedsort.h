@@ -0,0 +1,178 @@
+/*
+* @author   Jatin Jain
+* @file     threadedsort.h
+* @desc     public interface of libthreadedsort: sorts arrays of ints with the serial or the threaded quicksort through a
+*           sorter object that holds the engine settings and the counters of its last sort. Nothing is shared between
+*           sorters, so threads can sort concurrently with one sorter each. Besides int, fixed-width integers, float and
+*           double are sorted by a parallel radix sort of order-preserving keys, alone or with a payload: fixed-size records,
+*           or a key array whose payload columns are permuted with it; or as an argsort that returns the sorted order, also
+*           by several columns of a table. Strings are sorted with a parallel multikey quicksort, and elements of any size
+*           with a parallel stable quicksort under a comparator. Every sort runs ascending or descending as the sorter's
+*           order says.
+* @date     17 october 2026
+*/
+
+#ifndef THREADEDSORT_H
+#define THREADEDSORT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define THREADEDSORT_API __attribute__((visibility("default")))
+#else
+#define THREADEDSORT_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Counters of a sort.
+ *
+ * Every task of the threaded engine counts into its own copy and a parent
+ * adds the copies of its children after joining them, so no counter is
+ * shared between threads and the root holds the totals when the sort
+ * returns. `idle_seconds` is the time tasks spent waiting for their
+ * children, summed over tasks.
+ */
+typedef struct {
+    size_t tasks;
+    size_t threads_spawned;
+    size_t inline_sorts;                // subarrays sorted in place of a thread that could not be created
+    size_t elements_partitioned;
+    size_t bytes_allocated;
+    double idle_seconds;
+} SortStats;
+
+typedef enum {
+    SORT_ENGINE_SERIAL,
+    SORT_ENGINE_THREADED
+} SortEngine;
+
+/**
+ * @brief Direction of the sorts of a sorter.
+ *
+ * A descending sort is done by the same kernels in reverse, not by sorting
+ * ascending and reversing, so it costs the same and elements that sort
+ * equal keep their order wherever the ascending sort keeps it.
+ */
+typedef enum {
+    SORT_ASCENDING,
+    SORT_DESCENDING
+} SortOrder;
+
+/**
+ * @brief Engine settings and the counters of the last sort. Created with sorter_create().
+ */
+typedef struct Sorter Sorter;
+
+THREADEDSORT_API Sorter *sorter_create(void);
+THREADEDSORT_API void sorter_destroy(Sorter *sorter);
+THREADEDSORT_API int sorter_set_engine(Sorter *sorter, SortEngine engine);
+THREADEDSORT_API void sorter_set_threads(Sorter *sorter, size_t threads);
+THREADEDSORT_API void sorter_set_cutoff(Sorter *sorter, size_t cutoff);
+THREADEDSORT_API int sorter_set_order(Sorter *sorter, SortOrder order);
+THREADEDSORT_API int sorter_sort(Sorter *sorter, int *data, size_t size);
+THREADEDSORT_API int sorter_sort_into(Sorter *sorter, const int *data, size_t size, int *out);
+THREADEDSORT_API int sorter_sort_segments(Sorter *sorter, int *values, const size_t *offsets, size_t segment_count);
+THREADEDSORT_API int sorter_top_k(Sorter *sorter, const int *data, size_t size, size_t k, int *out);
+THREADEDSORT_API int sorter_select(Sorter *sorter, const int *data, size_t size, const size_t *ranks,
+                                   size_t rank_count, int *out);
+THREADEDSORT_API int sorter_quantiles(Sorter *sorter, const int *data, size_t size, const double *quantiles,
+                                      size_t count, int *out);
+
+/**
+ * @brief Streaming top-k of ints: a heap of the k values pushed so far that sort first. Created with top_k_create().
+ */
+typedef struct TopK TopK;
+
+THREADEDSORT_API TopK *top_k_create(size_t k, SortOrder order);
+THREADEDSORT_API void top_k_destroy(TopK *top);
+THREADEDSORT_API void top_k_push(TopK *top, const int *values, size_t count);
+THREADEDSORT_API size_t top_k_result(const TopK *top, int *out);
+
+/*
+ * Typed sorts, in place. Floating point values are sorted in IEEE total
+ * order except that every NaN goes last, in input order: -inf < ... < -0.0
+ * < +0.0 < ... < +inf < NaN. NaNs also go last in descending order. They use the sorter's thread budget but not its
+ * engine or cutoff.
+ */
+THREADEDSORT_API int sorter_sort_int32(Sorter *sorter, int32_t *data, size_t size);
+THREADEDSORT_API int sorter_sort_uint32(Sorter *sorter, uint32_t *data, size_t size);
+THREADEDSORT_API int sorter_sort_int64(Sorter *sorter, int64_t *data, size_t size);
+THREADEDSORT_API int sorter_sort_uint64(Sorter *sorter, uint64_t *data, size_t size);
+THREADEDSORT_API int sorter_sort_float(Sorter *sorter, float *data, size_t size);
+THREADEDSORT_API int sorter_sort_double(Sorter *sorter, double *data, size_t size);
+
+/**
+ * @brief Type of the key of a record sort.
+ */
+typedef enum {
+    SORT_KEY_INT32,
+    SORT_KEY_UINT32,
+    SORT_KEY_INT64,
+    SORT_KEY_UINT64,
+    SORT_KEY_FLOAT,
+    SORT_KEY_DOUBLE
+} SortKeyType;
+
+/**
+ * @brief One field of a composite key: a value of type `type` at `offset` bytes into each record.
+ */
+typedef struct {
+    SortKeyType type;
+    size_t offset;
+    SortOrder order;
+} SortKeyField;
+
+/*
+ * Normalised keys: a composite key written as bytes whose memcmp() order is
+ * the order of the key, fields compared first to last. sort_key_width() is
+ * 0 for an unsupported field type.
+ */
+THREADEDSORT_API size_t sort_key_width(const SortKeyField *fields, size_t field_count);
+THREADEDSORT_API void sort_key_encode(const SortKeyField *fields, size_t field_count, const void *record,
+                                      unsigned char *out);
+
+/*
+ * Record sorts: records of a key followed by a 4, 8 or 16-byte payload, or
+ * a key array with payload columns. Keys order like the typed sorts and
+ * equal keys keep their order.
+ */
+THREADEDSORT_API int sorter_sort_records(Sorter *sorter, SortKeyType key_type, void *records, size_t size,
+                                         size_t record_size);
+THREADEDSORT_API int sorter_sort_soa(Sorter *sorter, SortKeyType key_type, void *keys, size_t size,
+                                     void *const *columns, const size_t *column_sizes, size_t column_count);
+
+THREADEDSORT_API int sorter_sort_by_fields(Sorter *sorter, void *records, size_t size, size_t record_size,
+                                           const SortKeyField *fields, size_t field_count);
+
+THREADEDSORT_API int sorter_argsort(Sorter *sorter, SortKeyType key_type, const void *keys, size_t size,
+                                    size_t *indices);
+THREADEDSORT_API int sorter_argsort_columns(Sorter *sorter, const SortKeyType *key_types, const void *const *columns,
+                                            const SortOrder *orders, size_t column_count, size_t size, size_t *indices);
+
+THREADEDSORT_API int sorter_sort_strings(Sorter *sorter, const char **strings, size_t size);
+
+/**
+ * @brief Comparator of sorter_sort_compare(): negative, zero or positive as a sorts before, with or after b.
+ *
+ * context is the pointer given to the sort. It is called from several
+ * threads at once and must not modify the elements.
+ */
+typedef int (*SortCompare)(const void *a, const void *b, void *context);
+
+THREADEDSORT_API int sorter_sort_compare(Sorter *sorter, void *base, size_t size, size_t elem_size,
+                                         SortCompare compare, void *context);
+
+THREADEDSORT_API const SortStats *sorter_stats(const Sorter *sorter);
+THREADEDSORT_API void sort_stats_print(const SortStats *stats, FILE *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
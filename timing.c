@@ -0,0 +1,102 @@
+/*
+* @author   Jatin Jain
+* @file     timing.c
+* @desc     phase timing with clock_gettime: CLOCK_MONOTONIC for wall time and CLOCK_PROCESS_CPUTIME_ID for CPU time summed over
+*           all threads. clock() only gives the latter, which grows with the number of busy threads instead of shrinking.
+* @date     17 october 2026
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "timing.h"
+
+/**
+ * @brief Seconds on the monotonic clock.
+ */
+double timing_wall(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief CPU seconds used by all threads of the process.
+ */
+double timing_cpu(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Initialises an empty report.
+ */
+void timing_init(TimingReport *report) {
+    memset(report, 0, sizeof(*report));
+    report->current = -1;
+}
+
+/**
+ * @brief Starts timing a phase, closing the phase that was open.
+ *
+ * Entering a phase that was timed before adds to its total. Phases beyond
+ * TIMING_MAX_PHASES are not recorded.
+ *
+ * @param[in] report The report.
+ * @param[in] phase  Name of the phase, must outlive the report.
+ */
+void timing_begin(TimingReport *report, const char *phase) {
+    timing_end(report);
+    size_t i = 0;
+    while (i < report->count && strcmp(report->phases[i].name, phase) != 0) i++;
+    if (i == report->count) {
+        if (report->count == TIMING_MAX_PHASES) return;
+        report->phases[report->count++].name = phase;
+    }
+    report->current = (int)i;
+    report->cpu_start = timing_cpu();
+    report->wall_start = timing_wall();
+}
+
+/**
+ * @brief Closes the open phase, if any.
+ */
+void timing_end(TimingReport *report) {
+    if (report->current < 0) return;
+    double wall = timing_wall();
+    double cpu = timing_cpu();
+    TimingPhase *phase = &report->phases[report->current];
+    phase->wall += wall - report->wall_start;
+    phase->cpu += cpu - report->cpu_start;
+    report->current = -1;
+}
+
+/**
+ * @brief Wall time of a phase in seconds, 0 if it was never entered.
+ */
+double timing_phase_wall(const TimingReport *report, const char *phase) {
+    for (size_t i = 0; i < report->count; i++)
+        if (strcmp(report->phases[i].name, phase) == 0) return report->phases[i].wall;
+    return 0.0;
+}
+
+/**
+ * @brief Prints one line per phase with wall time, CPU time and their ratio
+ * (the average number of busy threads), followed by the totals.
+ */
+void timing_print(const TimingReport *report, FILE *out) {
+    double wall = 0.0, cpu = 0.0;
+    fprintf(out, "%-16s %12s %12s %9s\n", "Phase", "Wall (s)", "CPU (s)", "CPU/Wall");
+    for (size_t i = 0; i < report->count; i++) {
+        const TimingPhase *phase = &report->phases[i];
+        fprintf(out, "%-16s %12.6f %12.6f %9.2f\n", phase->name, phase->wall, phase->cpu,
+                phase->wall > 0.0 ? phase->cpu / phase->wall : 0.0);
+        wall += phase->wall;
+        cpu += phase->cpu;
+    }
+    fprintf(out, "%-16s %12.6f %12.6f %9.2f\n", "total", wall, cpu, wall > 0.0 ? cpu / wall : 0.0);
+}
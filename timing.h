@@ -0,0 +1,45 @@
+/*
+* @author   Jatin Jain
+* @file     timing.h
+* @desc     wall clock and CPU time measurement of the phases of a run, printed as a report.
+* @date     17 october 2026
+*/
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define TIMING_MAX_PHASES 16
+
+/**
+ * @brief Time spent in one named phase, summed over every time it was entered.
+ */
+typedef struct {
+    const char *name;
+    double wall;
+    double cpu;
+} TimingPhase;
+
+/**
+ * @brief Phases in the order they were first entered, and the phase currently open.
+ */
+typedef struct {
+    TimingPhase phases[TIMING_MAX_PHASES];
+    size_t count;
+    int current;
+    double wall_start;
+    double cpu_start;
+} TimingReport;
+
+double timing_wall(void);
+double timing_cpu(void);
+
+void timing_init(TimingReport *report);
+void timing_begin(TimingReport *report, const char *phase);
+void timing_end(TimingReport *report);
+double timing_phase_wall(const TimingReport *report, const char *phase);
+void timing_print(const TimingReport *report, FILE *out);
+
+#endif
@@ -0,0 +1,186 @@
+/*
+* @author   Jatin Jain
+* @file     topk.c
+* @desc     top-k selection. select_top_k() runs the three-way partition() of the quicksort engines like quickselect:
+*           each level keeps the part that lies wholly inside the first k values, discards the part wholly outside and
+*           descends only into the part that straddles position k, so the values it returns still need sorting but
+*           nothing past them was ever sorted. The TopK heap does the same for a stream, keeping the k values that sort
+*           first in a binary heap whose root is the one that sorts last.
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "topk.h"
+#include "quicksort.h"
+#include "memtrack.h"
+
+/**
+ * @brief Writes the k values of data that sort first, in no particular order, to out.
+ *
+ * Every level partitions the candidates around choose_pivot(); in
+ * ascending order the less part sorts first, in descending order the more
+ * part. Parts that end up wholly inside the first k are copied to out,
+ * parts wholly outside are freed, and the one part that straddles k
+ * becomes the next level's candidates. The pivot's equal part is never
+ * empty, so every level shrinks the candidates.
+ *
+ * @param k     At most size.
+ * @param stats Receives the counters of the selection.
+ * @return 0 on success, or -1 if partition() runs out of memory.
+ */
+int select_top_k(const int *data, size_t size, size_t k, int descending, int *out, SortStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->tasks = 1;
+    const int *candidates = data;
+    int *owned = NULL;                  // candidates allocated by the previous level, or NULL for data
+    size_t count = size, owned_size = 0, kept = 0;
+
+    while (kept < k) {
+        size_t wanted = k - kept;
+        if (wanted == count) {
+            memcpy(out + kept, candidates, count * sizeof(int));
+            break;
+        }
+        int *less, *equal, *more;
+        size_t less_size, equal_size, more_size;
+        if (partition((int *)candidates, count, choose_pivot(candidates, count), &less, &less_size, &equal,
+                      &equal_size, &more, &more_size) < 0) {
+            memtrack_free(owned, owned_size * sizeof(int));
+            return -1;
+        }
+        stats->elements_partitioned += count;
+        stats->bytes_allocated += 3 * count * sizeof(int);
+        memtrack_free(owned, owned_size * sizeof(int));
+
+        int *first = descending ? more : less, *last = descending ? less : more;
+        size_t first_size = descending ? more_size : less_size, last_size = descending ? less_size : more_size;
+        int *next = NULL;
+        size_t next_size = 0;
+        if (wanted <= first_size) {
+            // the first k lie inside the first part; equal and last are past them
+            next = first;
+            next_size = first_size;
+            first = NULL;
+        } else {
+            memcpy(out + kept, first, first_size * sizeof(int));
+            kept += first_size;
+            size_t from_equal = wanted - first_size < equal_size ? wanted - first_size : equal_size;
+            memcpy(out + kept, equal, from_equal * sizeof(int));
+            kept += from_equal;
+            if (kept < k) {
+                next = last;
+                next_size = last_size;
+                last = NULL;
+            }
+        }
+        // every part was allocated with count elements
+        memtrack_free(first, count * sizeof(int));
+        memtrack_free(equal, count * sizeof(int));
+        memtrack_free(last, count * sizeof(int));
+        owned = next;
+        owned_size = count;
+        candidates = next;
+        count = next_size;
+    }
+    memtrack_free(owned, owned_size * sizeof(int));
+    return 0;
+}
+
+struct TopK {
+    int *heap;
+    size_t size;
+    size_t k;
+    int descending;
+};
+
+/**
+ * @brief Nonzero if a sorts after b in the heap's order.
+ */
+static int sorts_after(const TopK *top, int a, int b) {
+    return top->descending ? a < b : a > b;
+}
+
+/**
+ * @brief Restores the heap below position i, whose value may sort before its children's.
+ */
+static void sift_down(const TopK *top, int *heap, size_t size, size_t i) {
+    int value = heap[i];
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= size) break;
+        if (child + 1 < size && sorts_after(top, heap[child + 1], heap[child])) child++;
+        if (!sorts_after(top, heap[child], value)) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = value;
+}
+
+/**
+ * @brief Creates a heap that keeps the k values that sort first (the smallest, or the largest if descending).
+ *
+ * @return The heap, or NULL if it cannot be allocated or order is not a SortOrder.
+ */
+TopK *top_k_create(size_t k, SortOrder order) {
+    if (order != SORT_ASCENDING && order != SORT_DESCENDING) return NULL;
+    TopK *top = calloc(1, sizeof(*top));
+    if (!top) return NULL;
+    top->heap = malloc((k ? k : 1) * sizeof(int));
+    if (!top->heap) {
+        free(top);
+        return NULL;
+    }
+    top->k = k;
+    top->descending = order == SORT_DESCENDING;
+    return top;
+}
+
+void top_k_destroy(TopK *top) {
+    if (!top) return;
+    free(top->heap);
+    free(top);
+}
+
+/**
+ * @brief Offers count values to the heap.
+ *
+ * Once the heap is full a value costs one comparison with the root unless
+ * it sorts before it, so a long stream with a small k runs at close to the
+ * speed of reading it.
+ */
+void top_k_push(TopK *top, const int *values, size_t count) {
+    int *heap = top->heap;
+    for (size_t n = 0; n < count; n++) {
+        int value = values[n];
+        if (top->size < top->k) {
+            size_t i = top->size++;
+            for (; i > 0 && sorts_after(top, value, heap[(i - 1) / 2]); i = (i - 1) / 2) heap[i] = heap[(i - 1) / 2];
+            heap[i] = value;
+        } else if (top->k > 0 && sorts_after(top, heap[0], value)) {
+            heap[0] = value;
+            sift_down(top, heap, top->size, 0);
+        }
+    }
+}
+
+/**
+ * @brief Writes the values kept so far to out in sorted order, leaving the heap as it is.
+ *
+ * @param out Room for k values.
+ * @return The number of values written: k, or fewer if fewer were pushed.
+ */
+size_t top_k_result(const TopK *top, int *out) {
+    size_t size = top->size;
+    memcpy(out, top->heap, size * sizeof(int));
+    // heapsort the copy: the root sorts last, so it goes to the end
+    for (size_t end = size; end > 1; end--) {
+        int root = out[0];
+        out[0] = out[end - 1];
+        out[end - 1] = root;
+        sift_down(top, out, end - 1, 0);
+    }
+    return size;
+}
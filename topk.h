@@ -0,0 +1,17 @@
+/*
+* @author   Jatin Jain
+* @file     topk.h
+* @desc     quickselect of the first k values of an int array, the selection step of sorter_top_k().
+* @date     17 october 2026
+*/
+
+#ifndef TOPK_H
+#define TOPK_H
+
+#include <stddef.h>
+
+#include "threadedsort.h"
+
+int select_top_k(const int *data, size_t size, size_t k, int descending, int *out, SortStats *stats);
+
+#endif
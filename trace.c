@@ -0,0 +1,120 @@
+/*
+* @author   Jatin Jain
+* @file     trace.c
+* @desc     task tracing. Spans are appended to one growable array under a lock, which costs little next to the thread each
+*           task creates, and are written out as complete ("X") events with the thread id, subarray size and recursion depth.
+*           Until trace_start() is called every hook returns at once.
+* @date     17 october 2026
+*/
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "trace.h"
+#include "timing.h"
+
+/**
+ * @brief One recorded span, times in seconds since trace_start().
+ */
+typedef struct {
+    const char *name;
+    double begin;
+    double end;
+    size_t size;
+    size_t depth;
+    long tid;
+} TraceSpan;
+
+static int enabled;
+static double origin;
+static pthread_mutex_t spans_lock = PTHREAD_MUTEX_INITIALIZER;
+static TraceSpan *spans;
+static size_t span_count, span_capacity;
+static int dropped;
+
+/**
+ * @brief Starts recording.
+ *
+ * @return 0 (tracing cannot fail to start; running out of memory later drops spans and is reported by trace_write()).
+ */
+int trace_start(void) {
+    origin = timing_wall();
+    enabled = 1;
+    return 0;
+}
+
+/**
+ * @brief Seconds since trace_start(), or 0 when not tracing.
+ */
+double trace_now(void) {
+    return enabled ? timing_wall() - origin : 0.0;
+}
+
+/**
+ * @brief Records a span of the calling thread.
+ *
+ * @param name  Name of the span, must be a string literal or otherwise outlive the trace.
+ * @param begin Start, from trace_now().
+ * @param end   End, from trace_now().
+ * @param size  Size of the subarray the span worked on.
+ * @param depth Recursion depth of the task.
+ */
+void trace_span(const char *name, double begin, double end, size_t size, size_t depth) {
+    if (!enabled) return;
+    long tid = (long)syscall(SYS_gettid);
+    pthread_mutex_lock(&spans_lock);
+    if (span_count == span_capacity) {
+        size_t capacity = span_capacity ? span_capacity * 2 : 4096;
+        TraceSpan *grown = realloc(spans, capacity * sizeof(TraceSpan));
+        if (!grown) {
+            dropped = 1;
+            pthread_mutex_unlock(&spans_lock);
+            return;
+        }
+        spans = grown;
+        span_capacity = capacity;
+    }
+    spans[span_count++] = (TraceSpan){name, begin, end, size, depth, tid};
+    pthread_mutex_unlock(&spans_lock);
+}
+
+/**
+ * @brief Writes the recorded spans to a JSON file and stops recording.
+ *
+ * Must be called once the traced threads have been joined.
+ *
+ * @param path File to write.
+ * @return 0 on success, or -1 if the file cannot be written.
+ */
+int trace_write(const char *path) {
+    enabled = 0;
+    FILE *out = fopen(path, "w");
+    if (!out) {
+        perror("Error opening trace file");
+        return -1;
+    }
+    long pid = (long)getpid();
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (size_t i = 0; i < span_count; i++) {
+        const TraceSpan *s = &spans[i];
+        fprintf(out, "{\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %ld, \"tid\": %ld, "
+                "\"args\": {\"size\": %zu, \"depth\": %zu}}%s\n", s->name, s->begin * 1e6, (s->end - s->begin) * 1e6,
+                pid, s->tid, s->size, s->depth, i + 1 < span_count ? "," : "");
+    }
+    fprintf(out, "]}\n");
+    free(spans);
+    spans = NULL;
+    span_count = span_capacity = 0;
+
+    int status = 0;
+    if (ferror(out)) status = -1;
+    if (fclose(out) != 0) status = -1;
+    if (status < 0) perror("Error writing trace file");
+    if (dropped) fprintf(stderr, "Trace incomplete: ran out of memory recording spans\n");
+    return status;
+}
@@ -0,0 +1,19 @@
+/*
+* @author   Jatin Jain
+* @file     trace.h
+* @desc     records the task tree of the threaded quicksort and writes it in Chrome Trace Event format, for Perfetto or
+*           chrome://tracing.
+* @date     17 october 2026
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+
+int trace_start(void);
+double trace_now(void);
+void trace_span(const char *name, double begin, double end, size_t size, size_t depth);
+int trace_write(const char *path);
+
+#endif
@@ -0,0 +1,134 @@
+/*
+* @author   Jatin Jain
+* @file     verify.c
+* @desc     parallel verification of a sort result: the array is split into one slice per thread, and each thread checks
+*           that its slice is sorted (including the pair across its left boundary) and computes the checksum of its slice
+*           in the same pass. The slice checksums are combined and compared with the checksum of the input.
+* @date     17 october 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "verify.h"
+
+#define VERIFY_MIN_SLICE (1 << 16)      // smallest slice worth a thread
+
+/**
+ * @brief One slice of the array and what its thread found.
+ */
+typedef struct {
+    const int *data;
+    size_t begin;
+    size_t end;
+    size_t unsorted_at;                 // first i in the slice with data[i - 1] > data[i], or SIZE_MAX
+    Checksum checksum;
+} VerifySlice;
+
+/**
+ * @brief Initialises the checksum of the empty multiset.
+ */
+void checksum_init(Checksum *c) {
+    memset(c, 0, sizeof(*c));
+    c->product = 1;
+}
+
+/**
+ * @brief Adds the values counted in part to total.
+ */
+void checksum_combine(Checksum *total, const Checksum *part) {
+    total->count += part->count;
+    total->sum += part->sum;
+    total->xor_all ^= part->xor_all;
+    total->product *= part->product;
+}
+
+/**
+ * @brief Checks whether two checksums are the same.
+ *
+ * @return 1 if they are, 0 otherwise.
+ */
+int checksum_equal(const Checksum *a, const Checksum *b) {
+    return a->count == b->count && a->sum == b->sum && a->xor_all == b->xor_all && a->product == b->product;
+}
+
+/**
+ * @brief Thread body: checks the order of one slice and computes its checksum.
+ */
+static void *verify_slice(void *arg) {
+    VerifySlice *s = arg;
+    const int *data = s->data;
+    size_t i = s->begin ? s->begin : 1;
+    s->unsorted_at = SIZE_MAX;
+    checksum_init(&s->checksum);
+    if (s->begin == 0 && s->end > 0) checksum_add(&s->checksum, data[0]);
+    for (; i < s->end; i++) {
+        if (data[i - 1] > data[i] && s->unsorted_at == SIZE_MAX) s->unsorted_at = i;
+        checksum_add(&s->checksum, data[i]);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Checks that data is sorted and holds the multiset described by expected, with up to threads threads.
+ *
+ * Prints what is wrong on failure.
+ *
+ * @param data     The sorted array; may be NULL if size is 0.
+ * @param size     Number of elements.
+ * @param expected Checksum of the input that was sorted.
+ * @param threads  Threads to use, at least 1. Small arrays use fewer.
+ * @return 0 if the result is correct, or -1 if it is not (or memory allocation fails).
+ */
+int verify_sorted_permutation(const int *data, size_t size, const Checksum *expected, size_t threads) {
+    size_t slices = size / VERIFY_MIN_SLICE;
+    if (slices > threads) slices = threads;
+    if (slices == 0) slices = 1;
+
+    VerifySlice *s = malloc(slices * sizeof(VerifySlice));
+    pthread_t *workers = malloc(slices * sizeof(pthread_t));
+    int *spawned = calloc(slices, sizeof(int));
+    if (!s || !workers || !spawned) {
+        perror("Memory allocation failed");
+        free(s);
+        free(workers);
+        free(spawned);
+        return -1;
+    }
+
+    // slice 0 runs in this thread; a slice whose thread cannot be created runs here too
+    for (size_t t = 0; t < slices; t++) {
+        s[t].data = data;
+        s[t].begin = size / slices * t;
+        s[t].end = t + 1 == slices ? size : size / slices * (t + 1);
+        if (t > 0) spawned[t] = pthread_create(&workers[t], NULL, verify_slice, &s[t]) == 0;
+    }
+    for (size_t t = 0; t < slices; t++)
+        if (!spawned[t]) verify_slice(&s[t]);
+
+    Checksum actual;
+    checksum_init(&actual);
+    size_t unsorted_at = SIZE_MAX;
+    for (size_t t = 0; t < slices; t++) {
+        if (spawned[t]) pthread_join(workers[t], NULL);
+        checksum_combine(&actual, &s[t].checksum);
+        if (s[t].unsorted_at < unsorted_at) unsorted_at = s[t].unsorted_at;
+    }
+    free(s);
+    free(workers);
+    free(spawned);
+
+    int status = 0;
+    if (unsorted_at != SIZE_MAX) {
+        fprintf(stderr, "Result is not sorted at index %zu\n", unsorted_at);
+        status = -1;
+    }
+    if (!checksum_equal(&actual, expected)) {
+        fprintf(stderr, "Result is not a permutation of the input (%zu values, expected %zu)\n", actual.count,
+                expected->count);
+        status = -1;
+    }
+    return status;
+}
@@ -0,0 +1,56 @@
+/*
+* @author   Jatin Jain
+* @file     verify.h
+* @desc     result verification: an order-independent checksum of a multiset of ints, and a parallel check that an array is
+*           sorted and holds the same multiset as the input.
+* @date     17 october 2026
+*/
+
+#ifndef VERIFY_H
+#define VERIFY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Order-independent checksum of a multiset of ints.
+ *
+ * Three independent combinations of the values are kept: their sum, their
+ * xor, and the product of an odd 64-bit hash of each value. All three are
+ * commutative, so the checksum does not depend on the order the values are
+ * added in and checksums of pieces can be combined.
+ */
+typedef struct {
+    size_t count;
+    uint64_t sum;
+    uint64_t xor_all;
+    uint64_t product;
+} Checksum;
+
+/**
+ * @brief Odd 64-bit hash of a value (the splitmix64 finaliser with the low bit set).
+ */
+static inline uint64_t checksum_hash(int value) {
+    uint64_t z = (uint64_t)(uint32_t)value + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return (z ^ (z >> 31)) | 1;
+}
+
+/**
+ * @brief Adds one value to a checksum.
+ */
+static inline void checksum_add(Checksum *c, int value) {
+    c->count++;
+    c->sum += (uint64_t)(uint32_t)value;
+    c->xor_all ^= (uint64_t)(uint32_t)value;
+    c->product *= checksum_hash(value);
+}
+
+void checksum_init(Checksum *c);
+void checksum_combine(Checksum *total, const Checksum *part);
+int checksum_equal(const Checksum *a, const Checksum *b);
+
+int verify_sorted_permutation(const int *data, size_t size, const Checksum *expected, size_t threads);
+
+#endif